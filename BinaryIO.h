@@ -0,0 +1,116 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_BINARYIO_H
+#define RAYTRACER_BINARYIO_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+ * Values of the binary cache and scene files, as they are in memory. The files are read on the machine they are
+ * written on: the values are in its byte order.
+ */
+
+template <typename T>
+void writeValue(std::ostream& output, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    output.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Number of values, then the values
+template <typename T>
+void writeArray(std::ostream& output, const std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    writeValue(output, static_cast<std::uint64_t>(values.size()));
+    output.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+inline void writeString(std::ostream& output, const std::string& value) {
+    writeValue(output, static_cast<std::uint64_t>(value.size()));
+    output.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+// Reads of the values above from a stream, for the files read piece by piece rather than mapped
+template <typename T>
+bool readValue(std::istream& input, T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    return static_cast<bool>(input.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+inline bool readString(std::istream& input, std::string& value) {
+    std::uint64_t length;
+    if (! readValue(input, length))
+        return false;
+
+    // Read by pieces, for a corrupt length not to be allocated at once
+    value.clear();
+    char buffer[4096];
+    while (length > 0) {
+        auto count = static_cast<std::streamsize>(std::min<std::uint64_t>(length, sizeof(buffer)));
+        if (! input.read(buffer, count))
+            return false;
+        value.append(buffer, static_cast<std::size_t>(count));
+        length -= static_cast<std::uint64_t>(count);
+    }
+
+    return true;
+}
+
+// Cursor in the bytes of a file, every read failing past their end
+class BinaryReader {
+public:
+
+    BinaryReader(const std::uint8_t* data, std::size_t size) : data(data), size(size)
+    { }
+
+    template <typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (size - offset < sizeof(T))
+            return false;
+
+        std::memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    bool readArray(std::vector<T>& values) {
+        std::uint64_t count;
+        if (! read(count) || count > (size - offset) / sizeof(T))
+            return false;
+
+        values.resize(count);
+        std::memcpy(values.data(), data + offset, count * sizeof(T));
+        offset += count * sizeof(T);
+        return true;
+    }
+
+    bool readString(std::string& value) {
+        std::uint64_t length;
+        if (! read(length) || length > size - offset)
+            return false;
+
+        value.assign(reinterpret_cast<const char*>(data + offset), length);
+        offset += length;
+        return true;
+    }
+
+    [[nodiscard]] bool isAtEnd() const { return offset == size; }
+
+private:
+    const std::uint8_t* data;
+    std::size_t size;
+    std::size_t offset = 0;
+};
+
+
+#endif //RAYTRACER_BINARYIO_H
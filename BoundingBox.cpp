@@ -0,0 +1,36 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "BoundingBox.h"
+
+void BoundingBox::extend(const Point &p) {
+    Min = Point{std::min(Min.X(), p.X()), std::min(Min.Y(), p.Y()), std::min(Min.Z(), p.Z())};
+    Max = Point{std::max(Max.X(), p.X()), std::max(Max.Y(), p.Y()), std::max(Max.Z(), p.Z())};
+}
+
+void BoundingBox::extend(const BoundingBox &other) {
+    if (other.isEmpty())
+        return;
+
+    extend(other.Min);
+    extend(other.Max);
+}
+
+std::size_t BoundingBox::largestAxis() const {
+    Vector d = diagonal();
+
+    if (d.X() >= d.Y() && d.X() >= d.Z())
+        return 0;
+    if (d.Y() >= d.Z())
+        return 1;
+    return 2;
+}
+
+double BoundingBox::surfaceArea() const {
+    if (isEmpty())
+        return 0;
+
+    Vector d = diagonal();
+    return 2 * (d.X() * d.Y() + d.Y() * d.Z() + d.Z() * d.X());
+}
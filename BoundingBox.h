@@ -0,0 +1,60 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_BOUNDINGBOX_H
+#define RAYTRACER_BOUNDINGBOX_H
+
+#include <limits>
+#include <algorithm>
+#include "triple.h"
+
+class BoundingBox {
+public:
+    Point Min;
+    Point Max;
+
+    // An empty box, extending it with anything gives that thing's bounds
+    BoundingBox()
+        : Min(std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()),
+        Max(-std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity())
+    { }
+
+    BoundingBox(const Point& Min, const Point& Max) : Min(Min), Max(Max)
+    { }
+
+    void extend(const Point&);
+    void extend(const BoundingBox&);
+
+    [[nodiscard]] bool isEmpty() const { return Min.X() > Max.X() || Min.Y() > Max.Y() || Min.Z() > Max.Z(); }
+    [[nodiscard]] Point center() const { return (Min + Max) / 2; }
+    [[nodiscard]] Vector diagonal() const { return Max - Min; }
+    [[nodiscard]] std::size_t largestAxis() const;
+    [[nodiscard]] double surfaceArea() const;
+
+    // Slab test, the inverse of the ray direction is given by the caller since it is shared by every box tested.
+    // A NaN coming from a ray parallel to a flat box is ignored by the std::min / std::max ordering.
+    [[nodiscard]] inline bool intersect(const Point& origin, const Vector& inverseDirection, double maxDistance) const {
+        double tNear = 0, tFar = maxDistance;
+
+        double t1 = (Min.X() - origin.X()) * inverseDirection.X();
+        double t2 = (Max.X() - origin.X()) * inverseDirection.X();
+        tNear = std::max(tNear, std::min(t1, t2));
+        tFar = std::min(tFar, std::max(t1, t2));
+
+        t1 = (Min.Y() - origin.Y()) * inverseDirection.Y();
+        t2 = (Max.Y() - origin.Y()) * inverseDirection.Y();
+        tNear = std::max(tNear, std::min(t1, t2));
+        tFar = std::min(tFar, std::max(t1, t2));
+
+        t1 = (Min.Z() - origin.Z()) * inverseDirection.Z();
+        t2 = (Max.Z() - origin.Z()) * inverseDirection.Z();
+        tNear = std::max(tNear, std::min(t1, t2));
+        tFar = std::min(tFar, std::max(t1, t2));
+
+        return tNear <= tFar;
+    }
+};
+
+
+#endif //RAYTRACER_BOUNDINGBOX_H
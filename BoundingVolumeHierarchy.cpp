@@ -0,0 +1,176 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "BoundingVolumeHierarchy.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+    // Cost of visiting a node relatively to the cost of intersecting a primitive, used by the surface area heuristic
+    constexpr double TraversalCost = 0.125;
+}
+
+struct BoundingVolumeHierarchy::BuildNode {
+    BoundingBox Bounds;
+    std::size_t Begin;
+    std::size_t Count;
+    std::size_t Axis;
+    std::unique_ptr<BuildNode> Children[2];
+};
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(const std::vector<BoundingBox> &primitiveBounds, std::size_t maxLeafSize)
+    : maxLeafSize(maxLeafSize)
+{
+    if (primitiveBounds.empty())
+        return;
+
+    int primitiveCount = static_cast<int>(primitiveBounds.size());
+    std::vector<Point> centroids(primitiveCount);
+
+    #pragma omp parallel for
+    for (int i = 0; i < primitiveCount; ++i)
+        centroids[i] = primitiveBounds[i].center();
+
+    primitiveIndices.resize(primitiveCount);
+    std::iota(primitiveIndices.begin(), primitiveIndices.end(), 0);
+
+    std::unique_ptr<BuildNode> root;
+
+    #pragma omp parallel default(shared)
+    #pragma omp single
+    root = build(primitiveBounds, centroids, 0, primitiveIndices.size(), 1);
+
+    nodes.reserve(2 * primitiveBounds.size());
+    flatten(*root);
+    nodes.shrink_to_fit();
+}
+
+std::unique_ptr<BoundingVolumeHierarchy::BuildNode> BoundingVolumeHierarchy::build(
+        const std::vector<BoundingBox> &primitiveBounds, const std::vector<Point> &centroids,
+        std::size_t begin, std::size_t end, std::size_t depth) {
+
+    BoundingBox bounds{}, centroidBounds{};
+    for (std::size_t i = begin; i < end; ++i) {
+        bounds.extend(primitiveBounds[primitiveIndices[i]]);
+        centroidBounds.extend(centroids[primitiveIndices[i]]);
+    }
+
+    std::size_t count = end - begin;
+    auto node = std::make_unique<BuildNode>(BuildNode{bounds, begin, count, 0, {}});
+
+    if (count == 1 || depth >= MaxDepth)
+        return node;
+
+    std::size_t middle = findSplit(primitiveBounds, centroids, bounds, centroidBounds, begin, end, node->Axis);
+    if (middle == end)
+        return node;
+
+    if (count >= ParallelBuildThreshold) {
+        #pragma omp task default(shared)
+        node->Children[0] = build(primitiveBounds, centroids, begin, middle, depth + 1);
+        node->Children[1] = build(primitiveBounds, centroids, middle, end, depth + 1);
+        #pragma omp taskwait
+    }
+    else {
+        node->Children[0] = build(primitiveBounds, centroids, begin, middle, depth + 1);
+        node->Children[1] = build(primitiveBounds, centroids, middle, end, depth + 1);
+    }
+
+    return node;
+}
+
+/*
+ * Partitions the primitives of the node along the best split found with the surface area heuristic, and returns
+ * the index of the first primitive of the second child. Returns end when the node should rather stay a leaf.
+ */
+std::size_t BoundingVolumeHierarchy::findSplit(const std::vector<BoundingBox> &primitiveBounds, const std::vector<Point> &centroids,
+                                               const BoundingBox &bounds, const BoundingBox &centroidBounds,
+                                               std::size_t begin, std::size_t end, std::size_t &splitAxis) {
+
+    std::size_t count = end - begin;
+    Vector centroidExtent = centroidBounds.diagonal();
+
+    double bestCost = std::numeric_limits<double>::infinity();
+    std::size_t bestAxis = 0, bestBin = 0;
+
+    auto binOf = [&centroids, &centroidBounds, &centroidExtent] (std::uint32_t primitive, std::size_t axis) {
+        auto bin = static_cast<std::size_t>(BinCount * (centroids[primitive][axis] - centroidBounds.Min[axis]) / centroidExtent[axis]);
+        return std::min(bin, BinCount - 1);
+    };
+
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+        if (centroidExtent[axis] <= 0)
+            continue;
+
+        std::array<BoundingBox, BinCount> binBounds{};
+        std::array<std::size_t, BinCount> binCounts{};
+
+        for (std::size_t i = begin; i < end; ++i) {
+            std::size_t bin = binOf(primitiveIndices[i], axis);
+            binBounds[bin].extend(primitiveBounds[primitiveIndices[i]]);
+            binCounts[bin]++;
+        }
+
+        // Sweeping from the right first, to then evaluate each split in one sweep from the left
+        std::array<double, BinCount - 1> rightCosts{};
+        BoundingBox right{};
+        std::size_t rightCount = 0;
+        for (std::size_t bin = BinCount - 1; bin > 0; --bin) {
+            right.extend(binBounds[bin]);
+            rightCount += binCounts[bin];
+            rightCosts[bin - 1] = right.surfaceArea() * rightCount;
+        }
+
+        BoundingBox left{};
+        std::size_t leftCount = 0;
+        for (std::size_t bin = 0; bin < BinCount - 1; ++bin) {
+            left.extend(binBounds[bin]);
+            leftCount += binCounts[bin];
+
+            double cost = left.surfaceArea() * leftCount + rightCosts[bin];
+            if (leftCount > 0 && leftCount < count && cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin = bin;
+            }
+        }
+    }
+
+    if (bestCost == std::numeric_limits<double>::infinity()) {
+        // Every centroid is at the same position, no split can separate them
+        if (count <= UINT16_MAX)
+            return end;
+
+        return begin + count / 2;
+    }
+
+    double area = bounds.surfaceArea();
+    double splitCost = TraversalCost + (area > 0 ? bestCost / area : 0);
+    if (count <= maxLeafSize && count <= splitCost)
+        return end;
+
+    splitAxis = bestAxis;
+    auto middle = std::partition(
+            primitiveIndices.begin() + begin, primitiveIndices.begin() + end,
+            [&binOf, bestAxis, bestBin] (std::uint32_t primitive) { return binOf(primitive, bestAxis) <= bestBin; }
+    );
+
+    return std::distance(primitiveIndices.begin(), middle);
+}
+
+std::uint32_t BoundingVolumeHierarchy::flatten(const BuildNode &buildNode) {
+    auto nodeIndex = static_cast<std::uint32_t>(nodes.size());
+    nodes.emplace_back();
+
+    if (! buildNode.Children[0]) {
+        nodes[nodeIndex] = Node{buildNode.Bounds, static_cast<std::uint32_t>(buildNode.Begin), static_cast<std::uint16_t>(buildNode.Count), 0};
+        return nodeIndex;
+    }
+
+    flatten(*buildNode.Children[0]);
+    std::uint32_t secondChild = flatten(*buildNode.Children[1]);
+
+    nodes[nodeIndex] = Node{buildNode.Bounds, secondChild, 0, static_cast<std::uint16_t>(buildNode.Axis)};
+    return nodeIndex;
+}
@@ -0,0 +1,232 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_BOUNDINGVOLUMEHIERARCHY_H
+#define RAYTRACER_BOUNDINGVOLUMEHIERARCHY_H
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <tuple>
+#include "BoundingBox.h"
+#include "light.h"
+#include "RayPacket.h"
+
+/*
+ * Binary tree of bounding boxes over a set of primitives. The hierarchy only knows the primitives through their
+ * bounding boxes and their index in the array used to build it, the caller does the actual intersections.
+ *
+ * The tree is built top-down with the surface area heuristic evaluated on a fixed number of bins per axis,
+ * the subtrees of large nodes being built in parallel as OpenMP tasks.
+ */
+class BoundingVolumeHierarchy {
+public:
+
+    // Maximum depth of the tree, also the size of the traversal stack
+    static constexpr std::size_t MaxDepth = 64;
+    // Number of candidate split positions evaluated per axis
+    static constexpr std::size_t BinCount = 16;
+    // Nodes with less primitives than that are built by the task that created them
+    static constexpr std::size_t ParallelBuildThreshold = 4096;
+
+    struct Node {
+        BoundingBox Bounds;
+        // Leaf: index of the first primitive in primitiveIndices.
+        // Inner node: index of the second child, the first child being right after its parent.
+        std::uint32_t Offset;
+        // Number of primitives of a leaf, 0 for an inner node
+        std::uint16_t Count;
+        // Axis the primitives have been split along, used to visit the closest child first
+        std::uint16_t Axis;
+
+        [[nodiscard]] bool isLeaf() const { return Count > 0; }
+    };
+
+    BoundingVolumeHierarchy() = default;
+    explicit BoundingVolumeHierarchy(const std::vector<BoundingBox>& primitiveBounds, std::size_t maxLeafSize = 2);
+
+    /*
+     * Calls intersectPrimitive(primitiveIndex, maxDistance) for every primitive whose leaf is hit before maxDistance.
+     * intersectPrimitive is expected to lower maxDistance when it finds a closer hit, pruning the rest of the traversal.
+     */
+    template <typename PrimitiveIntersector>
+    void intersect(const Ray& ray, double& maxDistance, PrimitiveIntersector&& intersectPrimitive) const;
+
+    /*
+     * Any-hit query: returns true as soon as occludedBy(primitiveIndex, maxDistance) returns true for one of the
+     * primitives whose leaf is hit before maxDistance, without looking for the closest one.
+     */
+    template <typename PrimitiveOccluder>
+    [[nodiscard]] bool occluded(const Ray& ray, double maxDistance, PrimitiveOccluder&& occludedBy) const;
+
+    /*
+     * Packet version of intersect: every node is tested against the rays of the packet still reaching it, and
+     * intersectPrimitive(primitiveIndex, rays) is called with the mask of the rays reaching the leaf.
+     * intersectPrimitive is expected to lower the hits of the packet.
+     */
+    template <typename PacketIntersector>
+    void intersect(RayPacket& packet, RayPacket::Mask activeRays, PacketIntersector&& intersectPrimitive) const;
+
+    [[nodiscard]] bool empty() const { return nodes.empty(); }
+    [[nodiscard]] std::size_t nodeCount() const { return nodes.size(); }
+    [[nodiscard]] std::size_t memoryUsage() const { return nodes.capacity() * sizeof(Node) + primitiveIndices.capacity() * sizeof(std::uint32_t); }
+    [[nodiscard]] BoundingBox bounds() const { return nodes.empty() ? BoundingBox{} : nodes.front().Bounds; }
+
+    // Flattened tree, for the structures built from it
+    [[nodiscard]] const Node& node(std::size_t index) const { return nodes[index]; }
+    [[nodiscard]] std::uint32_t primitive(std::size_t leafPosition) const { return primitiveIndices[leafPosition]; }
+
+private:
+
+    struct BuildNode;
+
+    [[nodiscard]] std::unique_ptr<BuildNode> build(const std::vector<BoundingBox>& primitiveBounds, const std::vector<Point>& centroids,
+                                                   std::size_t begin, std::size_t end, std::size_t depth);
+    [[nodiscard]] std::size_t findSplit(const std::vector<BoundingBox>& primitiveBounds, const std::vector<Point>& centroids,
+                                        const BoundingBox& bounds, const BoundingBox& centroidBounds,
+                                        std::size_t begin, std::size_t end, std::size_t& splitAxis);
+    std::uint32_t flatten(const BuildNode&);
+
+    std::vector<Node> nodes;
+    std::vector<std::uint32_t> primitiveIndices;
+    std::size_t maxLeafSize = 2;
+};
+
+
+template <typename PrimitiveIntersector>
+void BoundingVolumeHierarchy::intersect(const Ray &ray, double &maxDistance, PrimitiveIntersector&& intersectPrimitive) const {
+
+    if (nodes.empty())
+        return;
+
+    const Vector inverseDirection{1 / ray.Direction.X(), 1 / ray.Direction.Y(), 1 / ray.Direction.Z()};
+    const std::array<bool, 3> directionIsNegative{inverseDirection.X() < 0, inverseDirection.Y() < 0, inverseDirection.Z() < 0};
+
+    std::array<std::uint32_t, MaxDepth> toVisit;
+    std::size_t toVisitCount = 0;
+    std::uint32_t current = 0;
+
+    while (true) {
+        const Node& node = nodes[current];
+
+        if (node.Bounds.intersect(ray.Origin, inverseDirection, maxDistance)) {
+            if (node.isLeaf()) {
+                for (std::uint32_t i = 0; i < node.Count; ++i)
+                    intersectPrimitive(primitiveIndices[node.Offset + i], maxDistance);
+            }
+            else {
+                // Visiting the closest child first, so that the farthest one can be culled by maxDistance
+                if (directionIsNegative[node.Axis]) {
+                    toVisit[toVisitCount++] = current + 1;
+                    current = node.Offset;
+                }
+                else {
+                    toVisit[toVisitCount++] = node.Offset;
+                    current = current + 1;
+                }
+                continue;
+            }
+        }
+
+        if (toVisitCount == 0)
+            break;
+        current = toVisit[--toVisitCount];
+    }
+}
+
+template <typename PrimitiveOccluder>
+bool BoundingVolumeHierarchy::occluded(const Ray &ray, double maxDistance, PrimitiveOccluder&& occludedBy) const {
+
+    if (nodes.empty())
+        return false;
+
+    const Vector inverseDirection{1 / ray.Direction.X(), 1 / ray.Direction.Y(), 1 / ray.Direction.Z()};
+    const std::array<bool, 3> directionIsNegative{inverseDirection.X() < 0, inverseDirection.Y() < 0, inverseDirection.Z() < 0};
+
+    std::array<std::uint32_t, MaxDepth> toVisit;
+    std::size_t toVisitCount = 0;
+    std::uint32_t current = 0;
+
+    while (true) {
+        const Node& node = nodes[current];
+
+        if (node.Bounds.intersect(ray.Origin, inverseDirection, maxDistance)) {
+            if (node.isLeaf()) {
+                for (std::uint32_t i = 0; i < node.Count; ++i) {
+                    if (occludedBy(primitiveIndices[node.Offset + i], maxDistance))
+                        return true;
+                }
+            }
+            else {
+                // Closest child first, the blockers near the origin being the most likely to be found
+                if (directionIsNegative[node.Axis]) {
+                    toVisit[toVisitCount++] = current + 1;
+                    current = node.Offset;
+                }
+                else {
+                    toVisit[toVisitCount++] = node.Offset;
+                    current = current + 1;
+                }
+                continue;
+            }
+        }
+
+        if (toVisitCount == 0)
+            return false;
+        current = toVisit[--toVisitCount];
+    }
+}
+
+template <typename PacketIntersector>
+void BoundingVolumeHierarchy::intersect(RayPacket &packet, RayPacket::Mask activeRays, PacketIntersector&& intersectPrimitive) const {
+
+    if (nodes.empty() || activeRays == 0)
+        return;
+
+    // The rays being coherent, the children are visited in the order of the first active ray
+    std::size_t firstRay = 0;
+    while (! RayPacket::contains(activeRays, firstRay))
+        ++firstRay;
+
+    const std::array<bool, 3> directionIsNegative{
+        packet.DirectionX[firstRay] < 0, packet.DirectionY[firstRay] < 0, packet.DirectionZ[firstRay] < 0
+    };
+
+    std::array<std::pair<std::uint32_t, RayPacket::Mask>, MaxDepth> toVisit;
+    std::size_t toVisitCount = 0;
+    std::uint32_t current = 0;
+    RayPacket::Mask currentRays = activeRays;
+
+    while (true) {
+        const Node& node = nodes[current];
+        RayPacket::Mask raysHitting = packet.intersect(node.Bounds, currentRays);
+
+        if (raysHitting != 0) {
+            if (node.isLeaf()) {
+                for (std::uint32_t i = 0; i < node.Count; ++i)
+                    intersectPrimitive(primitiveIndices[node.Offset + i], raysHitting);
+            }
+            else {
+                if (directionIsNegative[node.Axis]) {
+                    toVisit[toVisitCount++] = {current + 1, raysHitting};
+                    current = node.Offset;
+                }
+                else {
+                    toVisit[toVisitCount++] = {node.Offset, raysHitting};
+                    current = current + 1;
+                }
+                currentRays = raysHitting;
+                continue;
+            }
+        }
+
+        if (toVisitCount == 0)
+            break;
+        std::tie(current, currentRays) = toVisit[--toVisitCount];
+    }
+}
+
+
+#endif //RAYTRACER_BOUNDINGVOLUMEHIERARCHY_H
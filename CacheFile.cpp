@@ -0,0 +1,74 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "CacheFile.h"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+std::optional<CacheSource> CacheSource::of(const std::string& fileName) {
+    std::error_code error;
+    CacheSource source;
+    std::filesystem::path absolute = std::filesystem::absolute(fileName, error);
+    source.path = error ? fileName : absolute.lexically_normal().string();
+
+    source.size = std::filesystem::file_size(fileName, error);
+    if (error)
+        return std::nullopt;
+    source.modificationTime = std::filesystem::last_write_time(fileName, error).time_since_epoch().count();
+
+    return source;
+}
+
+std::string CacheSource::cacheFileName(const std::string& extension) const {
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << std::hash<std::string>{}(path) << extension;
+    return name.str();
+}
+
+bool writeCacheFile(const std::filesystem::path& path, const std::function<void(std::ostream&)>& write) {
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+
+    std::filesystem::path temporary = path;
+    temporary += "." + std::to_string(std::random_device{}()) + ".part";
+
+    std::ofstream output{temporary, std::ios::binary};
+    write(output);
+
+    output.close();
+    if (output)
+        std::filesystem::rename(temporary, path, error);
+
+    if (! output || error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+
+    return true;
+}
+
+std::filesystem::path userCacheDirectory(const std::string& name) {
+    std::error_code error;
+    std::filesystem::path temporary = std::filesystem::temp_directory_path(error);
+    if (error)
+        return {};
+
+    uid_t user = getuid();
+    std::filesystem::path directory = temporary / (name + "-" + std::to_string(user));
+    if (mkdir(directory.c_str(), S_IRWXU) != 0 && errno != EEXIST)
+        return {};
+
+    // Not following a link, which another user could have put there before the directory was made
+    struct stat status{};
+    if (lstat(directory.c_str(), &status) != 0 || ! S_ISDIR(status.st_mode) || status.st_uid != user
+            || (status.st_mode & (S_IWGRP | S_IWOTH)) != 0)
+        return {};
+
+    return directory;
+}
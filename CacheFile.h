@@ -0,0 +1,47 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_CACHEFILE_H
+#define RAYTRACER_CACHEFILE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+
+/*
+ * Identity of the file a cache file is made from, written in the header of the cache file: the cache file is made
+ * again when the size or the modification time of its source changes.
+ */
+struct CacheSource {
+    // Absolute path of the file, as given if it can not be made absolute
+    std::string path;
+    std::uint64_t size = 0;
+    std::int64_t modificationTime = 0;
+
+    // The identity of the file, none if it is missing
+    static std::optional<CacheSource> of(const std::string& fileName);
+
+    // Name of the cache file of the source, after its path, with the extension. The header of the cache file tells
+    // apart two paths of the same name.
+    [[nodiscard]] std::string cacheFileName(const std::string& extension) const;
+};
+
+/*
+ * Writes the cache file with write, aside then renamed once complete, for another render never to read it half
+ * written. Creates the directory of the file if needed. False, leaving nothing behind, if it can not be written.
+ */
+bool writeCacheFile(const std::filesystem::path& path, const std::function<void(std::ostream&)>& write);
+
+/*
+ * Default cache directory of the user, name followed by the user id in the temporary directory, created readable and
+ * writable by the user only. None if it can not be created, or if it is not a directory of the user that the other
+ * users can not write to: the cache files of another user are never read.
+ */
+std::filesystem::path userCacheDirectory(const std::string& name);
+
+
+#endif //RAYTRACER_CACHEFILE_H
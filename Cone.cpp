@@ -4,6 +4,7 @@
 
 #include "Cone.h"
 #include "commongeometry.h"
+#include "Statistics.h"
 #include <cmath>
 
 #ifndef M_PI
@@ -11,6 +12,7 @@
 #endif
 
 Hit Cone::intersect(const Ray &ray) const {
+    COUNT_STATISTIC(ConeTests);
 
     Hit slopeHit = getHitOnSlope(ray);
 
@@ -19,26 +21,35 @@ Hit Cone::intersect(const Ray &ray) const {
     if ((planHit.Position - Position).norm() < Radius) {
 
         double hitDistance = (planHit.Position - ray.Origin).norm();
-        if (hitDistance > slopeHit.Distance)
-            return slopeHit;
+        if (hitDistance <= slopeHit.Distance) {
+            // applying normal map
+            planHit.Normal = applyNormalMap(planHit, Side);
+            return planHit;
+        }
+    }
 
-        // applying normal map
-        planHit.Normal = applyNormalMap(planHit.Position, planHit.Normal, Side);
-        return planHit;
+    if (slopeHit != Hit::NO_HIT() && material.normalMap) {
+        Vector normalUp = Plane{slopeHit.Position, slopeHit.Normal}.projectOn(Vector{0, 1, 0});
+        slopeHit.Normal = applyNormalMap(slopeHit, normalUp);
     }
 
     return slopeHit;
 }
 
+bool Cone::occludes(const Ray &ray, double maxDistance) const {
+    COUNT_STATISTIC(ConeTests);
+    if (getDistanceOnSlope(ray) < maxDistance)
+        return true;
+
+    double diskDistance = DiskPlan.getHitDistance(ray);
+    return diskDistance < maxDistance && (ray.at(diskDistance) - Position).norm() < Radius;
+}
+
 Vector Cone::getNormalAt(const Point &p) const {
 
     Point Tip = (Position + Up);
-    Vector NormalDirection = rotateAround(p - Tip, getThirdOrthogonalVector(Up, p - Tip), 90)
+    return rotateAround(p - Tip, getThirdOrthogonalVector(Up, p - Tip), 90)
             .normalized();
-
-    Vector normalUp = Plane{p, NormalDirection}.projectOn(Vector{0, 1, 0});
-    Vector normal = applyNormalMap(p, NormalDirection, normalUp);
-    return normal;
 }
 
 bool Cone::isInShadowCone(const Point &p) const {
@@ -51,6 +62,20 @@ bool Cone::isInShadowCone(const Point &p) const {
 }
 
 Hit Cone::getHitOnSlope(const Ray& ray) const {
+    double t = getDistanceOnSlope(ray);
+
+    if (t == Hit::NO_HIT().Distance)
+        return Hit::NO_HIT();
+
+    return Hit(
+            t * ray.Direction.norm(),
+            ray.at(t),
+            getNormalAt(ray.Origin + t * ray.Direction),
+            ray
+    );
+}
+
+double Cone::getDistanceOnSlope(const Ray& ray) const {
     // source: http://lousodrome.net/blog/light/2017/01/03/intersection-of-a-ray-and-a-cone/
     // Could be optimized, especially with the computation that is not function of the ray
     Vector co = Vector(ray.Origin - (Position + Up));
@@ -62,20 +87,15 @@ Hit Cone::getHitOnSlope(const Ray& ray) const {
     double delta = b*b -4*a*c;
 
     if (delta < 0) {
-        return Hit::NO_HIT();
+        return Hit::NO_HIT().Distance;
     }
     else if (delta == 0) {
         double t = -b / (2*a);
 
         if (t < 0)
-            return Hit::NO_HIT();
-
-        return Hit(
-                t * ray.Direction.norm(),
-                ray.at(t),
-                getNormalAt(ray.Origin + t * ray.Direction),
-                ray
-        );
+            return Hit::NO_HIT().Distance;
+
+        return t;
     }
     else {
         double t1 = (-b + std::sqrt(delta)) / (2*a);
@@ -88,34 +108,19 @@ Hit Cone::getHitOnSlope(const Ray& ray) const {
         bool t2IsInvalid = isInShadowCone(p2) || t2 <= 0;
 
         if (t1IsInvalid && t2IsInvalid)
-            return Hit::NO_HIT();
-
-        Hit hit1{
-                t1 * ray.Direction.norm(),
-                ray.at(t1),
-                getNormalAt(ray.Origin + t1 * ray.Direction),
-                ray
-        };
-
-        Hit hit2{
-                t2 * ray.Direction.norm(),
-                ray.at(t2),
-                getNormalAt(ray.Origin + t2 * ray.Direction),
-                ray
-        };
-
-
+            return Hit::NO_HIT().Distance;
 
         if (t1IsInvalid)
-            return hit2;
+            return t2;
         else if (t2IsInvalid)
-            return hit1;
+            return t1;
         else
-            return (hit1.Distance < hit2.Distance) ? hit1 : hit2;
+            return std::min(t1, t2);
     }
 }
 
-std::array<double, 2> Cone::getTextureCoordinatesFor(const Point &point) const {
+std::array<double, 2> Cone::getTextureCoordinatesFor(const Hit &hit) const {
+    const Point& point = hit.Position;
 
     if (isOnDisk(point)) {
         static Vector sideDirection = getThirdOrthogonalVector(Side, Up).normalized();
@@ -162,3 +167,17 @@ bool Cone::isOnDisk(const Point& point) const {
     Vector centerToPoint = point - Position;
     return DiskPlan.projectOn(centerToPoint) == centerToPoint;
 }
+
+std::optional<BoundingBox> Cone::getBoundingBox() const {
+    // The disk spreads along each axis by the radius times the sine of the angle between that axis and the cone axis
+    Vector axis = Up.normalized();
+    Vector diskExtent{
+        Radius * std::sqrt(std::max<double>(0, 1 - axis.X() * axis.X())),
+        Radius * std::sqrt(std::max<double>(0, 1 - axis.Y() * axis.Y())),
+        Radius * std::sqrt(std::max<double>(0, 1 - axis.Z() * axis.Z()))
+    };
+
+    BoundingBox output{Position - diskExtent, Position + diskExtent};
+    output.extend(Position + Up);
+    return output;
+}
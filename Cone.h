@@ -20,7 +20,9 @@ public:
     { }
 
     [[nodiscard]] Hit intersect(const Ray &ray) const override;
-    [[nodiscard]] std::array<double, 2> getTextureCoordinatesFor(const Point &point) const override;
+    [[nodiscard]] bool occludes(const Ray &ray, double maxDistance) const override;
+    [[nodiscard]] std::array<double, 2> getTextureCoordinatesFor(const Hit &hit) const override;
+    [[nodiscard]] std::optional<BoundingBox> getBoundingBox() const override;
 
     const Vector Side;
     const double Radius;
@@ -32,6 +34,8 @@ private:
     [[nodiscard]] bool isInShadowCone(const Point&) const;
 
     [[nodiscard]] Hit getHitOnSlope(const Ray&) const;
+    // Ray parameter of the first hit on the slope, infinity without hit
+    [[nodiscard]] double getDistanceOnSlope(const Ray&) const;
 
     [[nodiscard]] bool isOnDisk(const Point&) const;
 
@@ -0,0 +1,63 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "Heatmap.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+std::string costMetricName(CostMetric metric) {
+    switch (metric) {
+        case CostMetric::Time:
+            return "time (microseconds)";
+        case CostMetric::Rays:
+            return "rays";
+        case CostMetric::IntersectionTests:
+            return "intersection tests";
+    }
+
+    return "";
+}
+
+Heatmap::Heatmap(const BaseImage<double> &costs) : costs(costs) {
+    if (costs.size() == 0)
+        return;
+
+    std::vector<double> sortedCosts;
+    sortedCosts.reserve(costs.size());
+    for (int y = 0; y < costs.height(); ++y) {
+        for (int x = 0; x < costs.width(); ++x)
+            sortedCosts.push_back(costs(x, y));
+    }
+
+    for (double cost : sortedCosts)
+        mean += cost / sortedCosts.size();
+
+    auto percentile = sortedCosts.begin() + (sortedCosts.size() - 1) * 99 / 100;
+    std::nth_element(sortedCosts.begin(), percentile, sortedCosts.end());
+    top = *percentile;
+}
+
+Image Heatmap::toImage() const {
+    Image output{costs.width(), costs.height()};
+
+    for (int y = 0; y < costs.height(); ++y) {
+        for (int x = 0; x < costs.width(); ++x)
+            output(x, y) = colorFor(top > 0 ? costs(x, y) / top : 0);
+    }
+
+    return output;
+}
+
+Color Heatmap::colorFor(double relativeCost) {
+    static const std::array<Color, 5> scale{
+            Color{0, 0, 0}, Color{0, 0, 1}, Color{1, 0, 0}, Color{1, 1, 0}, Color{1, 1, 1}};
+
+    double position = std::clamp(relativeCost, 0.0, 1.0) * (scale.size() - 1);
+    auto lower = std::min(static_cast<std::size_t>(position), scale.size() - 2);
+    double t = position - lower;
+
+    return scale[lower] * (1 - t) + scale[lower + 1] * t;
+}
@@ -0,0 +1,43 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_HEATMAP_H
+#define RAYTRACER_HEATMAP_H
+
+#include <string>
+#include "image.h"
+
+// What the cost of a pixel is measured in
+enum class CostMetric { Time, Rays, IntersectionTests };
+
+std::string costMetricName(CostMetric metric);
+
+/*
+ * Image of the cost of every pixel of a render, on a colour scale going from black (no cost) through blue, red
+ * and yellow to white. The top of the scale is the 99th percentile of the costs, so that a few outliers do not
+ * squash the rest of the image in the dark colours.
+ */
+class Heatmap {
+public:
+
+    explicit Heatmap(const BaseImage<double>& costs);
+
+    [[nodiscard]] double meanCost() const { return mean; }
+    // Cost shown in white
+    [[nodiscard]] double scale() const { return top; }
+
+    [[nodiscard]] Image toImage() const;
+
+    // Colour of a cost relatively to the top of the scale, between 0 and 1
+    static Color colorFor(double relativeCost);
+
+private:
+
+    const BaseImage<double>& costs;
+    double mean = 0;
+    double top = 0;
+};
+
+
+#endif //RAYTRACER_HEATMAP_H
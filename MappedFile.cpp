@@ -0,0 +1,65 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "MappedFile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RAYTRACER_MMAP
+#else
+#include <fstream>
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+#ifdef RAYTRACER_MMAP
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return;
+
+    struct stat status{};
+    if (fstat(descriptor, &status) == 0) {
+        open = true;
+        _size = static_cast<std::size_t>(status.st_size);
+
+        // An empty file can not be mapped, and has nothing to map
+        if (_size > 0) {
+            void* address = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (address != MAP_FAILED) {
+                mapped = true;
+                _data = static_cast<const std::uint8_t*>(address);
+            }
+            else {
+                open = false;
+                _size = 0;
+            }
+        }
+    }
+
+    // The mapping stays valid once the file is closed
+    close(descriptor);
+#else
+    std::ifstream input{path, std::ios::binary | std::ios::ate};
+    if (! input)
+        return;
+
+    buffer.resize(static_cast<std::size_t>(input.tellg()));
+    input.seekg(0);
+    if (! input.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size())))
+        return;
+
+    open = true;
+    _data = buffer.data();
+    _size = buffer.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef RAYTRACER_MMAP
+    if (mapped)
+        munmap(const_cast<std::uint8_t*>(_data), _size);
+#endif
+}
@@ -0,0 +1,42 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_MAPPEDFILE_H
+#define RAYTRACER_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+/*
+ * Whole file mapped read-only in memory: its bytes are paged in by the system as they are read, without being copied
+ * through a stream buffer. Where mmap is not available (not a POSIX system), the file is read into memory instead.
+ */
+class MappedFile {
+public:
+
+    // An empty file, not open, if it can not be opened
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] bool isOpen() const { return open; }
+    [[nodiscard]] const std::uint8_t* data() const { return _data; }
+    [[nodiscard]] std::size_t size() const { return _size; }
+
+private:
+
+    bool open = false;
+    bool mapped = false;
+    const std::uint8_t* _data = nullptr;
+    std::size_t _size = 0;
+    // Contents of the file when it is not mapped
+    std::vector<std::uint8_t> buffer;
+};
+
+
+#endif //RAYTRACER_MAPPEDFILE_H
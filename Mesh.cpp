@@ -0,0 +1,222 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "Mesh.h"
+#include "Triangle.h"
+#include "ObjModel.h"
+#include "Statistics.h"
+#include <cmath>
+#include <unordered_map>
+
+namespace {
+    // OBJ corners referencing the same position, normal and texture coordinates become one vertex of the mesh
+    struct CornerKey {
+        std::uint32_t position, normal, uv;
+
+        bool operator==(const CornerKey& other) const {
+            return position == other.position && normal == other.normal && uv == other.uv;
+        }
+    };
+
+    struct CornerKeyHash {
+        std::size_t operator()(const CornerKey& key) const noexcept {
+            return hash_combine<std::uint32_t>(91834567, key.position, key.normal, key.uv);
+        }
+    };
+
+    // Normal of the plane of the triangle, computed in floats as glmFacetNormals does
+    std::array<float, 3> facetNormal(const ObjModel& model, const ObjModel::Triangle& triangle) {
+        const float* p0 = &model.Positions[3 * triangle.Positions[0]];
+        const float* p1 = &model.Positions[3 * triangle.Positions[1]];
+        const float* p2 = &model.Positions[3 * triangle.Positions[2]];
+
+        float u[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+        float v[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+        std::array<float, 3> output = {u[1]*v[2] - u[2]*v[1], u[2]*v[0] - u[0]*v[2], u[0]*v[1] - u[1]*v[0]};
+
+        float length = std::sqrt(output[0]*output[0] + output[1]*output[1] + output[2]*output[2]);
+        for (float& component : output)
+            component /= length;
+
+        return output;
+    }
+}
+
+Mesh Mesh::fromObj(const std::string &fileName) {
+    Statistics::PhaseTimer timer{Statistics::Phase::ObjLoad};
+    ObjModel model = ObjModel::read(fileName);
+
+    bool hasVertexNormals = ! model.Normals.empty();
+    bool hasUVs = ! model.UVs.empty();
+
+    Mesh output{};
+    output.Indices.reserve(3 * model.Triangles.size());
+
+    std::unordered_map<CornerKey, std::uint32_t, CornerKeyHash> vertexOf;
+    vertexOf.reserve(model.positionCount());
+
+    for (std::size_t i = 0; i < model.Triangles.size(); ++i) {
+        const ObjModel::Triangle& triangle = model.Triangles[i];
+
+        for (std::size_t j = 0; j < 3; ++j) {
+            // A corner without a vertex normal takes the normal of its face, so it can't be shared with other faces
+            bool hasVertexNormal = hasVertexNormals && triangle.Normals[j] != ObjModel::None;
+            CornerKey key{
+                triangle.Positions[j],
+                hasVertexNormal ? triangle.Normals[j] : static_cast<std::uint32_t>(model.normalCount() + i),
+                hasUVs ? triangle.UVs[j] : 0
+            };
+
+            auto [iterator, isNew] = vertexOf.try_emplace(key, static_cast<std::uint32_t>(output.vertexCount()));
+
+            if (isNew) {
+                output.Positions.insert(output.Positions.end(), &model.Positions[3 * key.position], &model.Positions[3 * key.position + 3]);
+
+                if (hasVertexNormal)
+                    output.Normals.insert(output.Normals.end(), &model.Normals[3 * key.normal], &model.Normals[3 * key.normal + 3]);
+                else {
+                    std::array<float, 3> normal = facetNormal(model, triangle);
+                    output.Normals.insert(output.Normals.end(), normal.begin(), normal.end());
+                }
+
+                if (hasUVs && key.uv != ObjModel::None)
+                    output.UVs.insert(output.UVs.end(), &model.UVs[2 * key.uv], &model.UVs[2 * key.uv + 2]);
+                else if (hasUVs)
+                    output.UVs.insert(output.UVs.end(), 2, 0.0f);
+            }
+
+            output.Indices.push_back(iterator->second);
+        }
+    }
+
+    output.Positions.shrink_to_fit();
+    output.Normals.shrink_to_fit();
+    output.UVs.shrink_to_fit();
+    return output;
+}
+
+Mesh Mesh::fromTriangles(const std::vector<Triangle> &triangles) {
+    Mesh output{};
+
+    for (const Triangle& triangle : triangles) {
+        for (const Vertex& vertex : triangle.Vertices) {
+            output.Indices.push_back(static_cast<std::uint32_t>(output.vertexCount()));
+
+            for (std::size_t i = 0; i < 3; ++i) {
+                output.Positions.push_back(static_cast<float>(vertex.Position[i]));
+                output.Normals.push_back(static_cast<float>(vertex.Normal[i]));
+            }
+            output.UVs.push_back(static_cast<float>(vertex.UV[0]));
+            output.UVs.push_back(static_cast<float>(vertex.UV[1]));
+        }
+    }
+
+    return output;
+}
+
+std::size_t Mesh::memoryUsage() const {
+    return Positions.capacity() * sizeof(float)
+        + Normals.capacity() * sizeof(float)
+        + UVs.capacity() * sizeof(float)
+        + Indices.capacity() * sizeof(std::uint32_t);
+}
+
+BoundingBox Mesh::triangleBounds(std::size_t triangle) const {
+    BoundingBox output{};
+    for (std::size_t corner = 0; corner < 3; ++corner)
+        output.extend(position(vertexOf(triangle, corner)));
+
+    return output;
+}
+
+BoundingBox Mesh::bounds() const {
+    BoundingBox output{};
+    for (std::uint32_t vertex = 0; vertex < vertexCount(); ++vertex)
+        output.extend(position(vertex));
+
+    return output;
+}
+
+bool Mesh::intersectTriangle(std::size_t triangle, const Ray &ray, double maxDistance,
+                             double &distance, std::array<double, 2> &barycentric) const {
+    // source: https://www.scratchapixel.com/lessons/3d-basic-rendering/ray-tracing-rendering-a-triangle/moller-trumbore-ray-triangle-intersection
+
+    Point p0 = position(vertexOf(triangle, 0));
+    Vector edge1 = position(vertexOf(triangle, 1)) - p0;
+    Vector edge2 = position(vertexOf(triangle, 2)) - p0;
+
+    Vector pVector = ray.Direction.cross(edge2);
+    double determinant = edge1.dot(pVector);
+
+    // Ray parallel to the triangle, or degenerated triangle
+    if (determinant == 0)
+        return false;
+
+    double inverseDeterminant = 1 / determinant;
+
+    Vector tVector = ray.Origin - p0;
+    double u = tVector.dot(pVector) * inverseDeterminant;
+    if (u < 0 || u > 1)
+        return false;
+
+    Vector qVector = tVector.cross(edge1);
+    double v = ray.Direction.dot(qVector) * inverseDeterminant;
+    if (v < 0 || u + v > 1)
+        return false;
+
+    double t = edge2.dot(qVector) * inverseDeterminant;
+    if (t <= 0 || t >= maxDistance)
+        return false;
+
+    distance = t;
+    barycentric = {u, v};
+    return true;
+}
+
+Vector Mesh::interpolateNormal(std::size_t triangle, const std::array<double, 2> &barycentric) const {
+    return (1 - barycentric[0] - barycentric[1]) * normal(vertexOf(triangle, 0))
+        + barycentric[0] * normal(vertexOf(triangle, 1))
+        + barycentric[1] * normal(vertexOf(triangle, 2));
+}
+
+std::array<double, 2> Mesh::interpolateUV(std::size_t triangle, const std::array<double, 2> &barycentric) const {
+    std::array<double, 2> uv0 = uv(vertexOf(triangle, 0));
+    std::array<double, 2> uv1 = uv(vertexOf(triangle, 1));
+    std::array<double, 2> uv2 = uv(vertexOf(triangle, 2));
+    double w = 1 - barycentric[0] - barycentric[1];
+
+    return {
+        w * uv0[0] + barycentric[0] * uv1[0] + barycentric[1] * uv2[0],
+        w * uv0[1] + barycentric[0] * uv1[1] + barycentric[1] * uv2[1]
+    };
+}
+
+double Mesh::textureScale(std::size_t triangle) const {
+    // Same computation as Triangle::getTextureFootprint
+    Point p0 = position(vertexOf(triangle, 0));
+    std::array<double, 2> uv0 = uv(vertexOf(triangle, 0));
+    std::array<double, 2> uv1 = uv(vertexOf(triangle, 1));
+    std::array<double, 2> uv2 = uv(vertexOf(triangle, 2));
+
+    double area = (position(vertexOf(triangle, 1)) - p0).cross(position(vertexOf(triangle, 2)) - p0).norm() / 2;
+    double uvArea = std::abs((uv1[0] - uv0[0]) * (uv2[1] - uv0[1]) - (uv1[1] - uv0[1]) * (uv2[0] - uv0[0])) / 2;
+
+    return area > 0 ? std::sqrt(uvArea / area) : 0;
+}
+
+Vector Mesh::normalUp(std::size_t triangle) const {
+    // Same computation as Triangle::computeNormalUp
+    Point p0 = position(vertexOf(triangle, 0));
+    std::array<double, 2> uv0 = uv(vertexOf(triangle, 0));
+
+    Vector output =
+            (uv(vertexOf(triangle, 1))[0] - uv0[0]) * (position(vertexOf(triangle, 1)) - p0)
+            + (uv(vertexOf(triangle, 2))[0] - uv0[0]) * (position(vertexOf(triangle, 2)) - p0);
+
+    if (output == Vector{0, 0, 0}) {
+        return Vector{1, 0, 0};
+    }
+
+    return output.normalized();
+}
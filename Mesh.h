@@ -0,0 +1,69 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_MESH_H
+#define RAYTRACER_MESH_H
+
+#include <array>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "triple.h"
+#include "light.h"
+#include "BoundingBox.h"
+
+class Triangle;
+
+/*
+ * Indexed triangle mesh. The vertex attributes are stored once in float buffers shared by every triangle,
+ * the triangles only being three indices in those buffers.
+ */
+struct Mesh {
+    std::vector<float> Positions;           // 3 floats per vertex
+    std::vector<float> Normals;             // 3 floats per vertex
+    std::vector<float> UVs;                 // 2 floats per vertex, empty if the mesh has no texture coordinates
+    std::vector<std::uint32_t> Indices;     // 3 vertex indices per triangle
+
+    static Mesh fromObj(const std::string& fileName);
+    static Mesh fromTriangles(const std::vector<Triangle>& triangles);
+
+    [[nodiscard]] std::size_t vertexCount() const { return Positions.size() / 3; }
+    [[nodiscard]] std::size_t triangleCount() const { return Indices.size() / 3; }
+    [[nodiscard]] std::size_t memoryUsage() const;
+
+    [[nodiscard]] Point position(std::uint32_t vertex) const {
+        return {Positions[3*vertex], Positions[3*vertex + 1], Positions[3*vertex + 2]};
+    }
+    [[nodiscard]] Vector normal(std::uint32_t vertex) const {
+        return {Normals[3*vertex], Normals[3*vertex + 1], Normals[3*vertex + 2]};
+    }
+    [[nodiscard]] std::array<double, 2> uv(std::uint32_t vertex) const {
+        if (UVs.empty())
+            return {0, 0};
+        return {UVs[2*vertex], UVs[2*vertex + 1]};
+    }
+    [[nodiscard]] std::uint32_t vertexOf(std::size_t triangle, std::size_t corner) const {
+        return Indices[3*triangle + corner];
+    }
+
+    [[nodiscard]] BoundingBox triangleBounds(std::size_t triangle) const;
+    [[nodiscard]] BoundingBox bounds() const;
+
+    /*
+     * Möller-Trumbore intersection with one triangle. On a hit closer than maxDistance, gives the distance and
+     * the barycentric coordinates of the hit relatively to the second and third vertices.
+     */
+    [[nodiscard]] bool intersectTriangle(std::size_t triangle, const Ray& ray, double maxDistance,
+                                         double& distance, std::array<double, 2>& barycentric) const;
+
+    [[nodiscard]] Vector interpolateNormal(std::size_t triangle, const std::array<double, 2>& barycentric) const;
+    [[nodiscard]] std::array<double, 2> interpolateUV(std::size_t triangle, const std::array<double, 2>& barycentric) const;
+    // Texture coordinates per unit of length on the triangle, from the areas of the triangle and of its texture coordinates
+    [[nodiscard]] double textureScale(std::size_t triangle) const;
+    // Direction along which the U texture coordinate grows on the triangle, used as the up vector of the normal maps
+    [[nodiscard]] Vector normalUp(std::size_t triangle) const;
+};
+
+
+#endif //RAYTRACER_MESH_H
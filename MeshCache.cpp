@@ -0,0 +1,179 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "MeshCache.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+#include "BinaryIO.h"
+#include "MappedFile.h"
+#include "Statistics.h"
+
+namespace {
+    constexpr char Magic[8] = {'R', 'T', 'M', 'E', 'S', 'H', '0', '1'};
+
+    // Layout of the hierarchy in memory, that of the build which wrote the cache file
+    constexpr std::uint32_t Layout[3] = {
+            WideTriangleHierarchy::Width, sizeof(WideTriangleHierarchy::Node), sizeof(WideTriangleHierarchy::TriangleBlock)};
+
+    static_assert(std::is_trivially_copyable_v<WideTriangleHierarchy::Node>);
+    static_assert(std::is_trivially_copyable_v<WideTriangleHierarchy::TriangleBlock>);
+}
+
+MeshCache& MeshCache::shared() {
+    static MeshCache cache;
+    return cache;
+}
+
+MeshCache::MeshCache() : directory(userCacheDirectory("raytracer-meshes")) {
+}
+
+void MeshCache::setDirectory(const std::filesystem::path& directory) {
+    std::lock_guard<std::mutex> lock{mutex};
+    this->directory = directory;
+}
+
+CompiledMesh MeshCache::load(const std::string& fileName) {
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&start] () {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::filesystem::path cacheDirectory;
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        cacheDirectory = directory;
+    }
+
+    std::optional<CacheSource> source = CacheSource::of(fileName);
+
+    // A missing OBJ file is left to the OBJ reader to report
+    std::filesystem::path path;
+    if (! cacheDirectory.empty() && source) {
+        path = cacheDirectory / source->cacheFileName(".mesh");
+
+        Statistics::PhaseTimer timer{Statistics::Phase::ObjLoad};
+        if (std::optional<CompiledMesh> cached = read(path, *source)) {
+            cached->Cached = true;
+            cached->Milliseconds = elapsed();
+            return std::move(*cached);
+        }
+    }
+
+    CompiledMesh output;
+    output.Geometry = Mesh::fromObj(fileName);
+    {
+        Statistics::PhaseTimer timer{Statistics::Phase::HierarchyBuild};
+        output.Hierarchy = WideTriangleHierarchy(output.Geometry);
+    }
+    output.Milliseconds = elapsed();
+
+    if (! path.empty() && ! write(path, *source, output))
+        std::cerr << "Warning: unable to write the mesh cache file " << path.string() << std::endl;
+
+    return output;
+}
+
+std::optional<CompiledMesh> MeshCache::read(const std::filesystem::path& path, const CacheSource& source) {
+    MappedFile file{path};
+    if (! file.isOpen())
+        return std::nullopt;
+
+    BinaryReader reader{file.data(), file.size()};
+    char magic[sizeof(Magic)];
+    std::uint32_t layout[std::size(Layout)];
+    std::uint64_t size;
+    std::int64_t modificationTime;
+    std::string sourcePath;
+
+    if (! reader.read(magic) || std::memcmp(magic, Magic, sizeof(Magic)) != 0
+            || ! reader.read(layout) || std::memcmp(layout, Layout, sizeof(Layout)) != 0
+            || ! reader.read(size) || size != source.size
+            || ! reader.read(modificationTime) || modificationTime != source.modificationTime
+            || ! reader.readString(sourcePath) || sourcePath != source.path)
+        return std::nullopt;
+
+    CompiledMesh output;
+    Mesh& mesh = output.Geometry;
+    WideTriangleHierarchy& hierarchy = output.Hierarchy;
+    std::array<double, 6> bounds{};
+
+    if (! reader.readArray(mesh.Positions) || ! reader.readArray(mesh.Normals) || ! reader.readArray(mesh.UVs)
+            || ! reader.readArray(mesh.Indices) || ! reader.readArray(hierarchy.nodes) || ! reader.readArray(hierarchy.blocks)
+            || ! reader.read(bounds) || ! reader.isAtEnd() || ! isConsistent(output))
+        return std::nullopt;
+
+    hierarchy.rootBounds = BoundingBox{Point(bounds[0], bounds[1], bounds[2]), Point(bounds[3], bounds[4], bounds[5])};
+    return output;
+}
+
+bool MeshCache::isConsistent(const CompiledMesh& compiled) {
+    const Mesh& mesh = compiled.Geometry;
+    const WideTriangleHierarchy& hierarchy = compiled.Hierarchy;
+    std::size_t vertexCount = mesh.vertexCount();
+    std::size_t triangleCount = mesh.triangleCount();
+
+    if (mesh.Positions.size() % 3 != 0 || mesh.Normals.size() != mesh.Positions.size()
+            || (! mesh.UVs.empty() && mesh.UVs.size() != 2 * vertexCount) || mesh.Indices.size() % 3 != 0)
+        return false;
+
+    for (std::uint32_t vertex : mesh.Indices) {
+        if (vertex >= vertexCount)
+            return false;
+    }
+
+    // The children of a node come after it, as the hierarchy is built: the traversal ends, within the depth its
+    // stack is sized for
+    std::vector<std::size_t> depths(hierarchy.nodes.size(), 1);
+    for (std::size_t n = 0; n < hierarchy.nodes.size(); ++n) {
+        const WideTriangleHierarchy::Node& node = hierarchy.nodes[n];
+        if (node.ChildCount > WideTriangleHierarchy::Width || depths[n] > BoundingVolumeHierarchy::MaxDepth)
+            return false;
+
+        for (std::size_t i = 0; i < node.ChildCount; ++i) {
+            std::uint32_t child = node.Children[i];
+            if (node.BlockCounts[i] == 0) {
+                if (child <= n || child >= hierarchy.nodes.size())
+                    return false;
+                depths[child] = std::max(depths[child], depths[n] + 1);
+            }
+            else if (std::uint64_t{child} + node.BlockCounts[i] > hierarchy.blocks.size()) {
+                return false;
+            }
+        }
+    }
+
+    for (const WideTriangleHierarchy::TriangleBlock& block : hierarchy.blocks) {
+        for (std::uint32_t triangle : block.Triangles) {
+            if (triangle >= triangleCount)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool MeshCache::write(const std::filesystem::path& path, const CacheSource& source, const CompiledMesh& mesh) {
+    return writeCacheFile(path, [&] (std::ostream& output) {
+        output.write(Magic, sizeof(Magic));
+        writeValue(output, Layout);
+        writeValue(output, source.size);
+        writeValue(output, source.modificationTime);
+        writeString(output, source.path);
+
+        const WideTriangleHierarchy& hierarchy = mesh.Hierarchy;
+        const BoundingBox& bounds = hierarchy.rootBounds;
+        writeArray(output, mesh.Geometry.Positions);
+        writeArray(output, mesh.Geometry.Normals);
+        writeArray(output, mesh.Geometry.UVs);
+        writeArray(output, mesh.Geometry.Indices);
+        writeArray(output, hierarchy.nodes);
+        writeArray(output, hierarchy.blocks);
+        writeValue(output, std::array<double, 6>{
+                bounds.Min.X(), bounds.Min.Y(), bounds.Min.Z(), bounds.Max.X(), bounds.Max.Y(), bounds.Max.Z()});
+    });
+}
@@ -0,0 +1,63 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_MESHCACHE_H
+#define RAYTRACER_MESHCACHE_H
+
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include "CacheFile.h"
+#include "Mesh.h"
+#include "WideTriangleHierarchy.h"
+
+// Mesh of an OBJ file with its hierarchy, ready to be rendered
+struct CompiledMesh {
+    Mesh Geometry;
+    WideTriangleHierarchy Hierarchy;
+    // Whether it was read from a cache file rather than compiled from the OBJ file, and the time taken by the one or
+    // the other
+    bool Cached = false;
+    double Milliseconds = 0;
+};
+
+/*
+ * Compiled meshes of the OBJ files, kept in binary cache files: the buffers of the Mesh and the nodes and triangle
+ * blocks of its WideTriangleHierarchy, as they are in memory. A cache file is mapped and its buffers copied, without
+ * parsing the OBJ file nor building the hierarchy again.
+ *
+ * The cache files are in a cache directory, named after the path of the OBJ file. A cache file is compiled again
+ * when the size or the modification time of its OBJ file changes, or when it was written by a build with another
+ * hierarchy layout.
+ */
+class MeshCache {
+public:
+
+    // Cache of the process, used by the scene reader. Its directory is the user cache directory raytracer-meshes.
+    static MeshCache& shared();
+
+    // Directory of the cache files, none to compile the OBJ files every time
+    void setDirectory(const std::filesystem::path& directory);
+
+    // The compiled mesh of the OBJ file, from its cache file if it is up to date, otherwise compiled and written to
+    // the cache file. A cache file that can not be written is left out with a warning.
+    CompiledMesh load(const std::string& fileName);
+
+private:
+
+    MeshCache();
+
+    static std::optional<CompiledMesh> read(const std::filesystem::path& path, const CacheSource& source);
+    static bool write(const std::filesystem::path& path, const CacheSource& source, const CompiledMesh& mesh);
+    // Whether every index of the mesh and its hierarchy is below the count it indexes, for a cache file damaged or
+    // written by another program to be compiled again rather than read out of bounds
+    static bool isConsistent(const CompiledMesh& compiled);
+
+    std::mutex mutex;
+    std::filesystem::path directory;
+};
+
+
+#endif //RAYTRACER_MESHCACHE_H
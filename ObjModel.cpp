@@ -0,0 +1,353 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "ObjModel.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include "MappedFile.h"
+
+namespace {
+    // Large enough for the parsing to outweigh the scheduling, small enough for the models of a few MiB to be shared
+    // between the threads
+    constexpr std::size_t ChunkBytes = 256 * 1024;
+
+    // Powers of ten represented exactly by a double
+    constexpr double PowersOfTen[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    constexpr int MaxExactPower = 22;
+
+    // Lines of the file parsed by one thread, and the part of the model they give
+    struct Chunk {
+        const char* Begin;
+        const char* End;
+        ObjModel Model;
+        // Start of the first malformed line, or of the first face referencing a missing vertex, if any
+        const char* Error = nullptr;
+    };
+
+    struct Corner {
+        std::uint32_t Position, UV, Normal;
+    };
+
+    bool isBlank(char c) { return c == ' ' || c == '\t'; }
+    bool isDigit(char c) { return c >= '0' && c <= '9'; }
+    bool isEnd(const char* p, const char* end) { return p == end || *p == '\r' || *p == '#'; }
+
+    void skipBlanks(const char*& p, const char* end) {
+        while (p != end && isBlank(*p))
+            ++p;
+    }
+
+    // Whether the double is exactly halfway between two floats, where rounding it to a float could round the decimal
+    // number the wrong way
+    bool isFloatMidpoint(double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        constexpr int DroppedBits = 52 - 23;
+        return (bits & ((std::uint64_t{1} << DroppedBits) - 1)) == std::uint64_t{1} << (DroppedBits - 1);
+    }
+
+    /*
+     * Decimal number rounded to the nearest float, as fscanf("%f") does. The numbers of an OBJ file have a few digits:
+     * their digits and power of ten are then exact doubles, which a single division or multiplication rounds
+     * correctly. The others are left to std::from_chars.
+     */
+    bool parseFloat(const char*& p, const char* end, float& value) {
+        const char* start = p;
+        bool negative = p != end && *p == '-';
+        if (p != end && (*p == '-' || *p == '+'))
+            ++p;
+        const char* number = p;
+
+        std::uint64_t mantissa = 0;
+        int significantDigits = 0;
+        int exponent = 0;
+        bool hasDigits = false;
+        bool truncated = false;
+
+        auto addDigit = [&] (char digit, bool fractional) {
+            hasDigits = true;
+            if (significantDigits == 19) {
+                truncated = true;
+                return;
+            }
+
+            mantissa = 10 * mantissa + (digit - '0');
+            if (mantissa != 0)
+                significantDigits++;
+            if (fractional)
+                exponent--;
+        };
+
+        for (; p != end && isDigit(*p); ++p)
+            addDigit(*p, false);
+
+        if (p != end && *p == '.') {
+            for (++p; p != end && isDigit(*p); ++p)
+                addDigit(*p, true);
+        }
+
+        if (! hasDigits) {
+            p = start;
+            return false;
+        }
+
+        // An exponent without digits is not a part of the number
+        if (p != end && (*p == 'e' || *p == 'E')) {
+            const char* exponentStart = p++;
+            bool negativeExponent = p != end && *p == '-';
+            if (p != end && (*p == '-' || *p == '+'))
+                ++p;
+
+            if (p != end && isDigit(*p)) {
+                int explicitExponent = 0;
+                for (; p != end && isDigit(*p); ++p)
+                    explicitExponent = std::min(10 * explicitExponent + (*p - '0'), 100000);
+                exponent += negativeExponent ? -explicitExponent : explicitExponent;
+            }
+            else
+                p = exponentStart;
+        }
+
+        if (! truncated && mantissa <= std::uint64_t{1} << 53 && exponent >= -MaxExactPower && exponent <= MaxExactPower) {
+            double exact = static_cast<double>(mantissa);
+            exact = exponent < 0 ? exact / PowersOfTen[-exponent] : exact * PowersOfTen[exponent];
+
+            if (! isFloatMidpoint(exact)) {
+                value = static_cast<float>(negative ? -exact : exact);
+                return true;
+            }
+        }
+
+        auto [last, error] = std::from_chars(number, p, value);
+        if (error != std::errc{} || last != p) {
+            p = start;
+            return false;
+        }
+
+        if (negative)
+            value = -value;
+        return true;
+    }
+
+    // Index of the OBJ file, from 1, converted to an index from 0
+    bool parseIndex(const char*& p, const char* end, std::uint32_t& index) {
+        if (p == end || ! isDigit(*p))
+            return false;
+
+        std::uint64_t value = 0;
+        for (; p != end && isDigit(*p); ++p) {
+            value = 10 * value + (*p - '0');
+            if (value >= ObjModel::None)
+                return false;
+        }
+
+        if (value == 0)
+            return false;
+
+        index = static_cast<std::uint32_t>(value - 1);
+        return true;
+    }
+
+    // v, v/t, v//n or v/t/n
+    bool parseCorner(const char*& p, const char* end, Corner& corner) {
+        corner = {0, ObjModel::None, ObjModel::None};
+        if (! parseIndex(p, end, corner.Position))
+            return false;
+
+        if (p != end && *p == '/') {
+            ++p;
+            if (p != end && *p != '/' && ! parseIndex(p, end, corner.UV))
+                return false;
+
+            if (p != end && *p == '/') {
+                ++p;
+                if (! parseIndex(p, end, corner.Normal))
+                    return false;
+            }
+        }
+
+        return p == end || isBlank(*p) || *p == '\r';
+    }
+
+    template <std::size_t Count>
+    bool parseFloats(const char*& p, const char* end, std::vector<float>& output) {
+        for (std::size_t i = 0; i < Count; ++i) {
+            float value;
+            skipBlanks(p, end);
+            if (! parseFloat(p, end, value))
+                return false;
+            output.push_back(value);
+        }
+
+        return true;
+    }
+
+    // A polygon becomes the fan of triangles sharing its first corner, in the order glmReadOBJ gives them
+    bool parseFace(const char*& p, const char* end, std::vector<ObjModel::Triangle>& output) {
+        Corner first{}, previous{}, corner{};
+        std::size_t count = 0;
+
+        for (skipBlanks(p, end); ! isEnd(p, end); skipBlanks(p, end), ++count) {
+            if (! parseCorner(p, end, corner))
+                return false;
+
+            if (count == 0)
+                first = corner;
+            else if (count >= 2)
+                output.push_back({
+                        {first.Position, previous.Position, corner.Position},
+                        {first.UV, previous.UV, corner.UV},
+                        {first.Normal, previous.Normal, corner.Normal}});
+
+            previous = corner;
+        }
+
+        return count >= 3;
+    }
+
+    bool parseLine(const char* p, const char* end, ObjModel& model) {
+        skipBlanks(p, end);
+        const char* keywordStart = p;
+        while (p != end && ! isBlank(*p) && *p != '\r')
+            ++p;
+        std::string_view keyword{keywordStart, static_cast<std::size_t>(p - keywordStart)};
+
+        // The values after the expected ones (a w coordinate, a comment) are skipped, as glmReadOBJ does
+        if (keyword == "v")
+            return parseFloats<3>(p, end, model.Positions);
+        if (keyword == "vn")
+            return parseFloats<3>(p, end, model.Normals);
+        if (keyword == "vt")
+            return parseFloats<2>(p, end, model.UVs);
+        if (keyword == "f")
+            return parseFace(p, end, model.Triangles);
+
+        return true;
+    }
+
+    void parseChunk(Chunk& chunk) {
+        for (const char* line = chunk.Begin; line != chunk.End; ) {
+            auto newline = static_cast<const char*>(std::memchr(line, '\n', chunk.End - line));
+            const char* lineEnd = newline != nullptr ? newline : chunk.End;
+
+            if (! parseLine(line, lineEnd, chunk.Model)) {
+                chunk.Error = line;
+                return;
+            }
+
+            line = newline != nullptr ? newline + 1 : chunk.End;
+        }
+    }
+
+    // Start of the line giving the triangle of the chunk, parsed again: only looked for to report an error
+    const char* lineOfTriangle(const Chunk& chunk, std::size_t triangle) {
+        ObjModel model;
+        for (const char* line = chunk.Begin; line != chunk.End; ) {
+            auto newline = static_cast<const char*>(std::memchr(line, '\n', chunk.End - line));
+            const char* lineEnd = newline != nullptr ? newline : chunk.End;
+
+            parseLine(line, lineEnd, model);
+            if (model.Triangles.size() > triangle)
+                return line;
+
+            line = newline != nullptr ? newline + 1 : chunk.End;
+        }
+
+        return chunk.Begin;
+    }
+
+    template <typename T>
+    void append(std::vector<T>& output, std::size_t offset, const std::vector<T>& values) {
+        std::copy(values.begin(), values.end(), output.begin() + static_cast<std::ptrdiff_t>(offset));
+    }
+}
+
+ObjModel ObjModel::read(const std::string& fileName) {
+    MappedFile file{fileName};
+    if (! file.isOpen())
+        throw std::runtime_error("File not found: " + fileName);
+
+    const char* data = reinterpret_cast<const char*>(file.data());
+    const char* end = data + file.size();
+
+    // Cut after the end of a line, a line being never shared by two chunks
+    std::vector<Chunk> chunks;
+    for (const char* begin = data; begin != end; ) {
+        const char* cut = end;
+        if (static_cast<std::size_t>(end - begin) > ChunkBytes) {
+            auto newline = static_cast<const char*>(std::memchr(begin + ChunkBytes, '\n', end - begin - ChunkBytes));
+            cut = newline != nullptr ? newline + 1 : end;
+        }
+
+        chunks.push_back(Chunk{begin, cut, ObjModel{}, nullptr});
+        begin = cut;
+    }
+
+    int chunkCount = static_cast<int>(chunks.size());
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < chunkCount; ++i)
+        parseChunk(chunks[i]);
+
+    auto lineNumber = [data] (const char* line) { return std::to_string(1 + std::count(data, line, '\n')); };
+
+    for (const Chunk& chunk : chunks) {
+        if (chunk.Error != nullptr)
+            throw std::runtime_error("Malformed OBJ statement at line " + lineNumber(chunk.Error) + " of " + fileName);
+    }
+
+    // Concatenated in the order of the file, every chunk at the offsets of the chunks before it
+    ObjModel output;
+    std::vector<std::array<std::size_t, 4>> offsets(chunks.size());
+    std::array<std::size_t, 4> total{};
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        const ObjModel& model = chunks[i].Model;
+        offsets[i] = total;
+        total[0] += model.Positions.size();
+        total[1] += model.Normals.size();
+        total[2] += model.UVs.size();
+        total[3] += model.Triangles.size();
+    }
+
+    output.Positions.resize(total[0]);
+    output.Normals.resize(total[1]);
+    output.UVs.resize(total[2]);
+    output.Triangles.resize(total[3]);
+
+    std::size_t positionCount = output.positionCount(), normalCount = output.normalCount(), uvCount = output.uvCount();
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < chunkCount; ++i) {
+        const ObjModel& model = chunks[i].Model;
+        append(output.Positions, offsets[i][0], model.Positions);
+        append(output.Normals, offsets[i][1], model.Normals);
+        append(output.UVs, offsets[i][2], model.UVs);
+        append(output.Triangles, offsets[i][3], model.Triangles);
+
+        for (std::size_t t = 0; t < model.Triangles.size() && chunks[i].Error == nullptr; ++t) {
+            const Triangle& triangle = model.Triangles[t];
+            for (std::size_t corner = 0; corner < 3; ++corner) {
+                if (triangle.Positions[corner] >= positionCount
+                        || (triangle.UVs[corner] != None && triangle.UVs[corner] >= uvCount)
+                        || (triangle.Normals[corner] != None && triangle.Normals[corner] >= normalCount)) {
+                    chunks[i].Error = lineOfTriangle(chunks[i], t);
+                    break;
+                }
+            }
+        }
+    }
+
+    for (const Chunk& chunk : chunks) {
+        if (chunk.Error != nullptr)
+            throw std::runtime_error(
+                    "Face referencing a missing vertex at line " + lineNumber(chunk.Error) + " of " + fileName);
+    }
+
+    return output;
+}
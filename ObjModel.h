@@ -0,0 +1,46 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_OBJMODEL_H
+#define RAYTRACER_OBJMODEL_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Geometry of a Wavefront OBJ file: its positions, normals and texture coordinates, and its faces fanned into
+ * triangles as glmReadOBJ does. The faces can be given as v, v/t, v//n or v/t/n, the other statements (groups,
+ * materials, smoothing) being skipped.
+ *
+ * The file is mapped in memory and cut into chunks on line boundaries, parsed in parallel without the C streams and
+ * concatenated in the order of the file, so that the model is the same whatever the number of threads.
+ */
+struct ObjModel {
+    // Index of a texture coordinate or normal a corner does not reference
+    static constexpr std::uint32_t None = ~std::uint32_t{0};
+
+    // Indices of the corners of a triangle, from 0 in the attribute lists
+    struct Triangle {
+        std::array<std::uint32_t, 3> Positions;
+        std::array<std::uint32_t, 3> UVs;
+        std::array<std::uint32_t, 3> Normals;
+    };
+
+    std::vector<float> Positions;           // 3 floats per position
+    std::vector<float> Normals;             // 3 floats per normal
+    std::vector<float> UVs;                 // 2 floats per texture coordinate
+    std::vector<Triangle> Triangles;
+
+    // Throws a std::runtime_error naming the line if the file can not be read or is malformed
+    static ObjModel read(const std::string& fileName);
+
+    [[nodiscard]] std::size_t positionCount() const { return Positions.size() / 3; }
+    [[nodiscard]] std::size_t normalCount() const { return Normals.size() / 3; }
+    [[nodiscard]] std::size_t uvCount() const { return UVs.size() / 2; }
+};
+
+
+#endif //RAYTRACER_OBJMODEL_H
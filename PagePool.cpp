@@ -0,0 +1,115 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "PagePool.h"
+#include <algorithm>
+#include <cstring>
+#include "Statistics.h"
+
+PagePool& PagePool::shared() {
+    static PagePool pool;
+    return pool;
+}
+
+void PagePool::setBudget(std::size_t bytes) {
+    budgetBytes = bytes;
+    clear();
+}
+
+PagePool::Shard& PagePool::shardOf(std::uint64_t key) {
+    // Fibonacci hashing: the neighbouring pages of a file go to different shards
+    return shards[(key * 0x9E3779B97F4A7C15u) >> 60];
+}
+
+void PagePool::read(const TextureFile& file, std::size_t page, std::size_t offset, std::size_t size, std::uint8_t* output) {
+    std::uint64_t key = (file.id() << 40) | page;
+    Shard& shard = shardOf(key);
+    std::lock_guard<std::mutex> lock{shard.mutex};
+
+    auto found = shard.index.find(key);
+    if (found != shard.index.end()) {
+        COUNT_STATISTIC(TexturePageHits);
+        shard.pages.splice(shard.pages.begin(), shard.pages, found->second);
+    }
+    else {
+        COUNT_STATISTIC(TexturePageMisses);
+
+        // At least one page per shard, whatever the budget
+        std::size_t shardBudget = budgetBytes / ShardCount;
+        std::vector<std::uint8_t> bytes;
+        while (! shard.pages.empty() && shard.bytes + file.pageBytes() > shardBudget) {
+            Page& dropped = shard.pages.back();
+            shard.bytes -= dropped.bytes.size();
+            shard.index.erase(dropped.key);
+            bytes = std::move(dropped.bytes);
+            shard.pages.pop_back();
+            shard.pagesDropped++;
+        }
+
+        bytes.resize(file.pageBytes());
+        file.readPage(page, bytes.data());
+        shard.pagesRead++;
+
+        shard.bytes += bytes.size();
+        shard.pages.push_front(Page{key, std::move(bytes)});
+        shard.index.emplace(key, shard.pages.begin());
+    }
+
+    std::memcpy(output, shard.pages.front().bytes.data() + offset, size);
+}
+
+std::size_t PagePool::pagesRead() const {
+    std::size_t output = 0;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock{shard.mutex};
+        output += shard.pagesRead;
+    }
+    return output;
+}
+
+std::size_t PagePool::pagesDropped() const {
+    std::size_t output = 0;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock{shard.mutex};
+        output += shard.pagesDropped;
+    }
+    return output;
+}
+
+std::size_t PagePool::residentBytes() const {
+    std::size_t output = 0;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock{shard.mutex};
+        output += shard.bytes;
+    }
+    return output;
+}
+
+void PagePool::printSummary(std::ostream& output) const {
+    std::size_t read = pagesRead();
+    if (read == 0)
+        return;
+
+    output << "Texture pages: " << read << " read, " << pagesDropped() << " dropped, " << residentBytes() / 1024
+           << " KiB in memory for a budget of " << budget() / 1024 << " KiB";
+
+    if (Statistics::Enabled) {
+        Statistics::Counts counts = Statistics::totalCounts();
+        auto hits = counts[static_cast<std::size_t>(Statistics::Counter::TexturePageHits)];
+        auto misses = counts[static_cast<std::size_t>(Statistics::Counter::TexturePageMisses)];
+        output << ", " << 100.0 * hits / std::max<std::uint64_t>(hits + misses, 1) << "% of the lookups hit";
+    }
+    output << std::endl;
+}
+
+void PagePool::clear() {
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock{shard.mutex};
+        shard.pages.clear();
+        shard.index.clear();
+        shard.bytes = 0;
+        shard.pagesRead = 0;
+        shard.pagesDropped = 0;
+    }
+}
@@ -0,0 +1,75 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_PAGEPOOL_H
+#define RAYTRACER_PAGEPOOL_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+#include "TextureFile.h"
+
+/*
+ * Pages of the texture cache files kept in memory within a budget of bytes, shared by the textures of the process. A
+ * page missing is read from its file, the least recently used pages being dropped to make room for it.
+ *
+ * The pages are spread between shards having their own lock and their share of the budget, so that the rendering
+ * threads reading different pages seldom wait for each other. A missing page is read with its shard locked.
+ */
+class PagePool {
+public:
+
+    // Pool of the process, read by the textures
+    static PagePool& shared();
+
+    // Bytes of the pages kept in memory, 256 MiB by default. Drops the pages in memory.
+    void setBudget(std::size_t bytes);
+    [[nodiscard]] std::size_t budget() const { return budgetBytes; }
+
+    // Copies size bytes at offset in the page of the file into output, the page being read if it is not in memory
+    void read(const TextureFile& file, std::size_t page, std::size_t offset, std::size_t size, std::uint8_t* output);
+
+    [[nodiscard]] std::size_t pagesRead() const;
+    [[nodiscard]] std::size_t pagesDropped() const;
+    [[nodiscard]] std::size_t residentBytes() const;
+
+    // Prints the budget, the pages read and dropped, nothing when no page was read
+    void printSummary(std::ostream& output) const;
+
+    // Drops the pages in memory and resets the counts
+    void clear();
+
+private:
+
+    static constexpr std::size_t ShardCount = 16;
+
+    struct Page {
+        std::uint64_t key;
+        std::vector<std::uint8_t> bytes;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        // Most recently used first
+        std::list<Page> pages;
+        std::unordered_map<std::uint64_t, std::list<Page>::iterator> index;
+        std::size_t bytes = 0;
+        std::size_t pagesRead = 0;
+        std::size_t pagesDropped = 0;
+    };
+
+    Shard& shardOf(std::uint64_t key);
+
+    std::array<Shard, ShardCount> shards;
+    std::atomic<std::size_t> budgetBytes{std::size_t{256} << 20};
+};
+
+
+#endif //RAYTRACER_PAGEPOOL_H
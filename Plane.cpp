@@ -4,27 +4,71 @@
 
 #include "Plane.h"
 #include "commongeometry.h"
+#include "Statistics.h"
+#include <bitset>
 
 Hit Plane::intersect(const Ray &ray) const {
-    Vector rayOrthogonal = project(ray.Direction, Normal);
+    COUNT_STATISTIC(PlaneTests);
+    double t = getHitDistance(ray);
 
-    Vector shortestPath = project(Position - ray.Origin, Normal);
+    if (t == Hit::NO_HIT().Distance)
+        return Hit::NO_HIT();
 
-    double t = shortestPath.norm() / rayOrthogonal.norm();
+    return getHitAt(ray, t);
+}
 
-    if (shortestPath.dot(rayOrthogonal) < 0)
-        return Hit::NO_HIT();
+RayPacket::Mask Plane::intersectPacket(RayPacket &packet, RayPacket::Mask activeRays) const {
+    ADD_STATISTIC(PlaneTests, std::bitset<RayPacket::Size>{activeRays}.count());
+    // Same computation as getHitDistance, for every ray of the packet at once
+    RayPacket::Lanes<double> distances;
+    const double normalNorm2 = Normal.dot(Normal);
 
+    #pragma omp simd
+    for (std::size_t i = 0; i < RayPacket::Size; ++i) {
+        double rayFactor = (packet.DirectionX[i] * Normal.X() + packet.DirectionY[i] * Normal.Y() + packet.DirectionZ[i] * Normal.Z()) / normalNorm2;
+        double pathFactor = ((Position.X() - packet.OriginX[i]) * Normal.X()
+                + (Position.Y() - packet.OriginY[i]) * Normal.Y()
+                + (Position.Z() - packet.OriginZ[i]) * Normal.Z()) / normalNorm2;
+
+        double rayX = rayFactor * Normal.X(), rayY = rayFactor * Normal.Y(), rayZ = rayFactor * Normal.Z();
+        double pathX = pathFactor * Normal.X(), pathY = pathFactor * Normal.Y(), pathZ = pathFactor * Normal.Z();
+
+        double t = std::sqrt(pathX * pathX + pathY * pathY + pathZ * pathZ) / std::sqrt(rayX * rayX + rayY * rayY + rayZ * rayZ);
+        distances[i] = (pathX * rayX + pathY * rayY + pathZ * rayZ) < 0 ? Hit::NO_HIT().Distance : t;
+    }
+
+    return packet.keepCloserHits(distances, activeRays, [this] (const Ray& ray, double t) {
+        return getHitAt(ray, t);
+    });
+}
+
+Hit Plane::getHitAt(const Ray &ray, double t) const {
     return Hit(
             t,
             ray.at(t),
-            -shortestPath.normalized(),
+            -project(Position - ray.Origin, Normal).normalized(),
             ray
         );
 }
 
-std::array<double, 2> Plane::getTextureCoordinatesFor(const Point &p) const {
-    Vector originToPoint = p - Position;
+bool Plane::occludes(const Ray &ray, double maxDistance) const {
+    COUNT_STATISTIC(PlaneTests);
+    return getHitDistance(ray) < maxDistance;
+}
+
+double Plane::getHitDistance(const Ray &ray) const {
+    Vector rayOrthogonal = project(ray.Direction, Normal);
+
+    Vector shortestPath = project(Position - ray.Origin, Normal);
+
+    if (shortestPath.dot(rayOrthogonal) < 0)
+        return Hit::NO_HIT().Distance;
+
+    return shortestPath.norm() / rayOrthogonal.norm();
+}
+
+std::array<double, 2> Plane::getTextureCoordinatesFor(const Hit &hit) const {
+    Vector originToPoint = hit.Position - Position;
 
     // used the same formula as Quadrilateral in box.cpp
     double firstComponent = Normal.dot(UVVector1.cross(originToPoint)) * firstComponentFactor;
@@ -40,3 +84,7 @@ std::array<double, 2> Plane::getTextureCoordinatesFor(const Point &p) const {
 Vector Plane::projectOn(const Vector& v) const {
     return v - project(v, Normal);
 }
+
+std::optional<BoundingBox> Plane::getBoundingBox() const {
+    return std::nullopt;
+}
@@ -17,13 +17,20 @@ public:
     { }
 
     [[nodiscard]] Hit intersect(const Ray &ray) const override;
-    [[nodiscard]] std::array<double, 2> getTextureCoordinatesFor(const Point &) const override;
+    [[nodiscard]] bool occludes(const Ray &ray, double maxDistance) const override;
+    RayPacket::Mask intersectPacket(RayPacket &packet, RayPacket::Mask activeRays) const override;
+    [[nodiscard]] std::array<double, 2> getTextureCoordinatesFor(const Hit &) const override;
+    [[nodiscard]] std::optional<BoundingBox> getBoundingBox() const override;
 
     [[nodiscard]] Vector projectOn(const Vector &) const;
+    // Distance along the ray to the plane, infinity when the ray goes away from it
+    [[nodiscard]] double getHitDistance(const Ray &ray) const;
 
     const Vector Normal;
 private:
 
+    [[nodiscard]] Hit getHitAt(const Ray &ray, double distance) const;
+
     // Used in UV calculations
     const Vector UVVector1 = getAnyOrthogonalVector(Normal).normalized();
     const Vector UVVector2 = getThirdOrthogonalVector(Normal, UVVector1).normalized();
@@ -0,0 +1,151 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "PngStreamWriter.h"
+#include <algorithm>
+#include <array>
+
+namespace {
+    // Largest length of an uncompressed deflate block
+    constexpr std::size_t MaxBlockSize = 65535;
+    constexpr std::size_t ChunkSize = 1 << 20;
+
+    const std::array<std::uint32_t, 256>& crcTable() {
+        static const std::array<std::uint32_t, 256> table = [] {
+            std::array<std::uint32_t, 256> output{};
+            for (std::uint32_t n = 0; n < 256; ++n) {
+                std::uint32_t c = n;
+                for (int k = 0; k < 8; ++k)
+                    c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                output[n] = c;
+            }
+            return output;
+        }();
+
+        return table;
+    }
+
+    std::uint32_t updateCrc(std::uint32_t crc, const unsigned char* data, std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i)
+            crc = crcTable()[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+        return crc;
+    }
+
+    // Adds the bytes to the Adler-32 sums, reduced once every 5552 bytes: the most that can be added before b can
+    // overflow 32 bits
+    void updateAdler32(std::uint32_t& a, std::uint32_t& b, const unsigned char* data, std::size_t size) {
+        constexpr std::size_t MaxRun = 5552;
+
+        while (size > 0) {
+            std::size_t run = std::min(size, MaxRun);
+            for (std::size_t i = 0; i < run; ++i) {
+                a += data[i];
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+
+            data += run;
+            size -= run;
+        }
+    }
+
+    void appendBigEndian(std::vector<unsigned char>& data, std::uint32_t value) {
+        data.push_back(value >> 24);
+        data.push_back(value >> 16);
+        data.push_back(value >> 8);
+        data.push_back(value);
+    }
+}
+
+PngStreamWriter::PngStreamWriter(const std::string &fileName, int width, int height)
+    : output(fileName, std::ios::binary), width(width), height(height)
+{
+    static const unsigned char signature[] = {137, 80, 78, 71, 13, 10, 26, 10};
+    output.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<unsigned char> header;
+    appendBigEndian(header, width);
+    appendBigEndian(header, height);
+    // 8 bit depth, RGB, deflate, no filter method, no interlacing
+    header.insert(header.end(), {8, 2, 0, 0, 0});
+    writeChunk("IHDR", header);
+
+    // zlib header: deflate with a 32K window, no dictionary
+    pendingChunk = {0x78, 0x01};
+}
+
+void PngStreamWriter::writeRows(const RadianceImage &rows) {
+    for (int y = 0; y < rows.height() && currentRow < height; ++y, ++currentRow) {
+        // Filter type 0: the row is stored as is
+        pendingData.push_back(0);
+
+        for (int x = 0; x < width; ++x) {
+            Color pixel = rows(x, y).clamped();
+            pendingData.push_back((unsigned char)(pixel.Red() * 255.0));
+            pendingData.push_back((unsigned char)(pixel.Green() * 255.0));
+            pendingData.push_back((unsigned char)(pixel.Blue() * 255.0));
+        }
+
+        storeBlocks(false);
+    }
+}
+
+bool PngStreamWriter::finish() {
+    if (currentRow < height)
+        return false;
+
+    storeBlocks(true);
+    appendBigEndian(pendingChunk, (adler32B << 16) | adler32A);
+    writeChunk("IDAT", pendingChunk);
+    writeChunk("IEND", {});
+
+    output.close();
+    return ! output.fail();
+}
+
+void PngStreamWriter::writeChunk(const char *type, const std::vector<unsigned char> &data) {
+    std::vector<unsigned char> length;
+    appendBigEndian(length, data.size());
+
+    std::uint32_t crc = updateCrc(0xFFFFFFFFu, reinterpret_cast<const unsigned char*>(type), 4);
+    crc = updateCrc(crc, data.data(), data.size()) ^ 0xFFFFFFFFu;
+    std::vector<unsigned char> crcBytes;
+    appendBigEndian(crcBytes, crc);
+
+    output.write(reinterpret_cast<const char*>(length.data()), length.size());
+    output.write(type, 4);
+    output.write(reinterpret_cast<const char*>(data.data()), data.size());
+    output.write(reinterpret_cast<const char*>(crcBytes.data()), crcBytes.size());
+}
+
+void PngStreamWriter::storeBlocks(bool final) {
+    std::size_t stored = 0;
+
+    while (pendingData.size() - stored >= MaxBlockSize || final) {
+        std::size_t blockSize = std::min(MaxBlockSize, pendingData.size() - stored);
+        bool lastBlock = final && stored + blockSize == pendingData.size();
+
+        // Block header: final bit and type 00 (uncompressed), then the length and its one's complement
+        pendingChunk.push_back(lastBlock ? 1 : 0);
+        pendingChunk.push_back(blockSize & 0xFFu);
+        pendingChunk.push_back(blockSize >> 8);
+        pendingChunk.push_back(~blockSize & 0xFFu);
+        pendingChunk.push_back((~blockSize >> 8) & 0xFFu);
+
+        updateAdler32(adler32A, adler32B, pendingData.data() + stored, blockSize);
+        pendingChunk.insert(pendingChunk.end(), pendingData.begin() + stored, pendingData.begin() + stored + blockSize);
+        stored += blockSize;
+
+        if (pendingChunk.size() >= ChunkSize) {
+            writeChunk("IDAT", pendingChunk);
+            pendingChunk.clear();
+        }
+
+        if (lastBlock)
+            break;
+    }
+
+    pendingData.erase(pendingData.begin(), pendingData.begin() + stored);
+}
@@ -0,0 +1,53 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_PNGSTREAMWRITER_H
+#define RAYTRACER_PNGSTREAMWRITER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "image.h"
+
+/*
+ * Writes a PNG file row by row, as the rows of the image are rendered, without holding the whole image.
+ *
+ * The pixels are clamped and quantized to 8 bit RGB as RadianceImage::write_png does, and stored in uncompressed
+ * deflate blocks: the file is larger than a compressed one, but is written in constant memory.
+ */
+class PngStreamWriter {
+public:
+
+    PngStreamWriter(const std::string& fileName, int width, int height);
+
+    // Whether the file could be opened and its header written, to be checked before rendering the rows
+    [[nodiscard]] bool isOpen() const { return output.is_open() && output.good(); }
+
+    // Appends every row of the rows image, which width must be the one of the file
+    void writeRows(const RadianceImage& rows);
+    // Ends the file once all its rows are written, false if it could not be written
+    bool finish();
+
+    [[nodiscard]] int rowsWritten() const { return currentRow; }
+
+private:
+
+    void writeChunk(const char* type, const std::vector<unsigned char>& data);
+    // Moves the complete deflate blocks of pendingData to pendingChunk, and the last one too if final
+    void storeBlocks(bool final);
+
+    std::ofstream output;
+    int width, height;
+    int currentRow = 0;
+
+    // Filtered rows not stored in a deflate block yet
+    std::vector<unsigned char> pendingData;
+    // Content of the next IDAT chunk
+    std::vector<unsigned char> pendingChunk;
+    std::uint32_t adler32A = 1, adler32B = 0;
+};
+
+
+#endif //RAYTRACER_PNGSTREAMWRITER_H
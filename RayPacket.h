@@ -0,0 +1,119 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_RAYPACKET_H
+#define RAYTRACER_RAYPACKET_H
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include "light.h"
+#include "BoundingBox.h"
+
+/*
+ * Group of coherent rays traced together, typically the primary rays of neighbouring pixels.
+ * Besides the rays themselves, their components are stored in a structure of arrays layout so that the packet
+ * kernels (bounding box tests, sphere and plane intersections) loop over the rays with `#pragma omp simd`.
+ *
+ * The rays of a packet are selected with a bit mask, packets at the end of a row not being full.
+ */
+class RayPacket {
+public:
+
+    static constexpr std::size_t Size = 8;
+
+    typedef std::uint32_t Mask;
+    static constexpr Mask AllRays = (Mask{1} << Size) - 1;
+
+    template <typename T>
+    using Lanes = std::array<T, Size>;
+
+    // rayAt(i) gives the i-th ray of the packet
+    template <typename RayGenerator>
+    explicit RayPacket(RayGenerator&& rayAt) : RayPacket(rayAt, std::make_index_sequence<Size>{})
+    { }
+
+    const Lanes<Ray> Rays;
+    Lanes<double> OriginX, OriginY, OriginZ;
+    Lanes<double> DirectionX, DirectionY, DirectionZ;
+    Lanes<double> InverseDirectionX, InverseDirectionY, InverseDirectionZ;
+
+    // Closest hit found so far for every ray, lowered by the objects while the packet is traced
+    Lanes<Hit> Hits;
+
+    static bool contains(Mask mask, std::size_t ray) { return (mask >> ray) & 1u; }
+
+    // Slab test of every active ray against the box, up to the closest hit of each ray
+    [[nodiscard]] Mask intersect(const BoundingBox& box, Mask activeRays) const {
+        Lanes<bool> hit{};
+
+        #pragma omp simd
+        for (std::size_t i = 0; i < Size; ++i) {
+            double tNear = 0, tFar = Hits[i].Distance;
+
+            double t1 = (box.Min.X() - OriginX[i]) * InverseDirectionX[i];
+            double t2 = (box.Max.X() - OriginX[i]) * InverseDirectionX[i];
+            tNear = std::max(tNear, std::min(t1, t2));
+            tFar = std::min(tFar, std::max(t1, t2));
+
+            t1 = (box.Min.Y() - OriginY[i]) * InverseDirectionY[i];
+            t2 = (box.Max.Y() - OriginY[i]) * InverseDirectionY[i];
+            tNear = std::max(tNear, std::min(t1, t2));
+            tFar = std::min(tFar, std::max(t1, t2));
+
+            t1 = (box.Min.Z() - OriginZ[i]) * InverseDirectionZ[i];
+            t2 = (box.Max.Z() - OriginZ[i]) * InverseDirectionZ[i];
+            tNear = std::max(tNear, std::min(t1, t2));
+            tFar = std::min(tFar, std::max(t1, t2));
+
+            hit[i] = tNear <= tFar;
+        }
+
+        Mask output = 0;
+        for (std::size_t i = 0; i < Size; ++i)
+            output |= Mask{hit[i]} << i;
+
+        return output & activeRays;
+    }
+
+    /*
+     * Replaces the hits of the active rays which distance is lower than their current hit,
+     * hitAt(ray, distance) building the new hit. Returns the mask of the rays whose hit was replaced.
+     */
+    template <typename HitBuilder>
+    Mask keepCloserHits(const Lanes<double>& distances, Mask activeRays, HitBuilder&& hitAt) {
+        Mask closer = 0;
+
+        for (std::size_t i = 0; i < Size; ++i) {
+            if (contains(activeRays, i) && distances[i] < Hits[i].Distance) {
+                Hits[i] = hitAt(Rays[i], distances[i]);
+                closer |= Mask{1} << i;
+            }
+        }
+
+        return closer;
+    }
+
+private:
+
+    template <typename RayGenerator, std::size_t... I>
+    RayPacket(RayGenerator& rayAt, std::index_sequence<I...>)
+        : Rays{rayAt(I)...}, Hits{(static_cast<void>(I), Hit::NO_HIT())...}
+    {
+        for (std::size_t i = 0; i < Size; ++i) {
+            OriginX[i] = Rays[i].Origin.X();
+            OriginY[i] = Rays[i].Origin.Y();
+            OriginZ[i] = Rays[i].Origin.Z();
+            DirectionX[i] = Rays[i].Direction.X();
+            DirectionY[i] = Rays[i].Direction.Y();
+            DirectionZ[i] = Rays[i].Direction.Z();
+            InverseDirectionX[i] = 1 / DirectionX[i];
+            InverseDirectionY[i] = 1 / DirectionY[i];
+            InverseDirectionZ[i] = 1 / DirectionZ[i];
+        }
+    }
+};
+
+
+#endif //RAYTRACER_RAYPACKET_H
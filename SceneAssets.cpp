@@ -0,0 +1,135 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "SceneAssets.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include "Statistics.h"
+#include "TextureCache.h"
+
+namespace {
+    // Size from which an OBJ file is parsed by several chunks, and its hierarchy worth building on every thread
+    constexpr std::uintmax_t LargeMeshBytes = 1 << 20;
+}
+
+void SceneAssets::requestTexture(const std::string& fileName, TexelFormat format) {
+    request(AssetType::Texture, fileName, format);
+}
+
+void SceneAssets::requestMesh(const std::string& fileName) {
+    request(AssetType::Mesh, fileName, TexelFormat::RGBA8).Uses++;
+}
+
+SceneAssets::Asset& SceneAssets::request(AssetType type, const std::string& fileName, TexelFormat format) {
+    std::string key = (type == AssetType::Mesh ? "mesh:" : format == TexelFormat::R8 ? "R8:" : "RGBA8:") + fileName;
+
+    auto [found, isNew] = indexOf.try_emplace(key, assets.size());
+    if (isNew) {
+        Asset& asset = assets.emplace_back();
+        asset.Type = type;
+        asset.FileName = fileName;
+        asset.Format = format;
+
+        // A missing file is left to its reader to report
+        std::error_code error;
+        asset.Size = std::filesystem::file_size(fileName, error);
+        if (error)
+            asset.Size = 0;
+    }
+
+    return assets[found->second];
+}
+
+void SceneAssets::load(std::ostream& report) {
+    if (assets.empty())
+        return;
+
+    Statistics::PhaseTimer timer{Statistics::Phase::AssetLoad};
+    auto start = std::chrono::steady_clock::now();
+
+    auto loadAsset = [] (Asset& asset) {
+        auto assetStart = std::chrono::steady_clock::now();
+
+        try {
+            if (asset.Type == AssetType::Texture)
+                TextureCache::shared().preload(asset.FileName, asset.Format);
+            else
+                asset.Mesh = MeshCache::shared().load(asset.FileName);
+        } catch (...) {
+            asset.Error = std::current_exception();
+        }
+
+        asset.Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - assetStart).count();
+    };
+
+    /*
+     * Inside the loop over the files, the parallel loops of the OBJ parsing and of the hierarchy building would run
+     * on one thread, OpenMP not nesting the parallel regions. The large meshes, and a file alone, are loaded first one
+     * after the other with every thread, the other files then side by side. The largest files first, for a thread not
+     * to start one when the others are done.
+     */
+    std::vector<std::size_t> sequential, order;
+    for (std::size_t i = 0; i < assets.size(); ++i) {
+        bool isLarge = assets[i].Type == AssetType::Mesh && assets[i].Size >= LargeMeshBytes;
+        (isLarge ? sequential : order).push_back(i);
+    }
+
+    if (order.size() == 1) {
+        sequential.push_back(order.front());
+        order.clear();
+    }
+
+    std::stable_sort(order.begin(), order.end(), [this] (std::size_t a, std::size_t b) {
+        return assets[a].Size > assets[b].Size;
+    });
+
+    for (std::size_t i : sequential)
+        loadAsset(assets[i]);
+
+    int assetCount = static_cast<int>(order.size());
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < assetCount; ++i) {
+        Statistics::UntimedScope untimed;
+        loadAsset(assets[order[i]]);
+    }
+
+    for (const Asset& asset : assets) {
+        if (asset.Error)
+            std::rethrow_exception(asset.Error);
+    }
+
+    std::chrono::duration<double, std::milli> loadTime = std::chrono::steady_clock::now() - start;
+    report << "Assets: " << assets.size() << (assets.size() == 1 ? " file" : " files") << " loaded in "
+           << loadTime.count() << " ms" << std::endl;
+
+    for (const Asset& asset : assets) {
+        report << "  " << (asset.Type == AssetType::Mesh ? "mesh " : "texture ") << asset.FileName << ": "
+               << asset.Milliseconds << " ms";
+        if (asset.Type == AssetType::Texture && asset.Format == TexelFormat::R8)
+            report << " (red channel)";
+        if (asset.Mesh && asset.Mesh->Cached)
+            report << " (mesh cache)";
+        report << std::endl;
+    }
+}
+
+CompiledMesh SceneAssets::takeMesh(const std::string& fileName) {
+    auto found = indexOf.find("mesh:" + fileName);
+    if (found == indexOf.end() || ! assets[found->second].Mesh)
+        throw std::logic_error("Mesh not loaded: " + fileName);
+
+    Asset& asset = assets[found->second];
+    if (asset.Uses > 1) {
+        asset.Uses--;
+        return *asset.Mesh;
+    }
+
+    asset.Uses = 0;
+    CompiledMesh mesh = std::move(*asset.Mesh);
+    asset.Mesh.reset();
+    return mesh;
+}
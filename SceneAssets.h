@@ -0,0 +1,65 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_SCENEASSETS_H
+#define RAYTRACER_SCENEASSETS_H
+
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MeshCache.h"
+#include "TiledImage.h"
+
+/*
+ * Files of a scene, loaded before its objects are built. The scene reader requests the textures of the materials and
+ * the OBJ files of the objects, a file requested several times being loaded once. load then decodes the PNG files
+ * into the TextureCache, and reads the meshes from the MeshCache, on the threads of OpenMP: the loading takes the
+ * time of the largest files rather than the sum of them all. The large OBJ files are loaded first one by one, their
+ * parsing and hierarchy building being parallel loops of their own.
+ */
+class SceneAssets {
+public:
+
+    void requestTexture(const std::string& fileName, TexelFormat format = TexelFormat::RGBA8);
+    void requestMesh(const std::string& fileName);
+
+    // Loads the requested files and prints the time taken by each. Throws the exception of the first requested file
+    // that can not be loaded. The files loaded side by side are timed in the asset load phase, the OBJ parsing and
+    // hierarchy building of their meshes included.
+    void load(std::ostream& report);
+
+    // The loaded mesh, moved out at its last request and copied for the others
+    CompiledMesh takeMesh(const std::string& fileName);
+
+private:
+
+    enum class AssetType { Texture, Mesh };
+
+    struct Asset {
+        AssetType Type;
+        std::string FileName;
+        TexelFormat Format = TexelFormat::RGBA8;
+        // Size of the file, the largest being loaded first
+        std::uintmax_t Size = 0;
+
+        double Milliseconds = 0;
+        std::optional<CompiledMesh> Mesh;
+        // Requests of the mesh not taken yet
+        std::size_t Uses = 0;
+        std::exception_ptr Error;
+    };
+
+    Asset& request(AssetType type, const std::string& fileName, TexelFormat format);
+
+    // In the order of their first request
+    std::vector<Asset> assets;
+    std::unordered_map<std::string, std::size_t> indexOf;
+};
+
+
+#endif //RAYTRACER_SCENEASSETS_H
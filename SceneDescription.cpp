@@ -0,0 +1,273 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "SceneDescription.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include "BinaryIO.h"
+#include "MappedFile.h"
+
+namespace {
+    constexpr char Magic[8] = {'R', 'T', 'S', 'C', 'E', 'N', 'E', '1'};
+
+    // Numbers of the Vectors and Numbers of an ObjectDescription the constructor of each type uses, the others being
+    // left out of the file
+    struct ValueCounts {
+        std::size_t Vectors, Numbers;
+    };
+
+    constexpr ValueCounts ValueCountsOf[] = {
+            {1, 5},     // Sphere
+            {3, 0},     // Cone
+            {2, 1},     // Plane
+            {3, 6},     // Triangle
+            {0, 0},     // TriangleAggregate
+            {3, 0},     // Quadrilateral
+            {3, 1}      // Box
+    };
+
+    // Values of the scene in the file whatever the precision of the build: the vectors and colors as doubles,
+    // the enumerations as 32 bits integers
+    void write(std::ostream& output, const Vector& vector) {
+        writeValue(output, std::array<double, 3>{vector.X(), vector.Y(), vector.Z()});
+    }
+
+    void write(std::ostream& output, const Color& color) {
+        writeValue(output, std::array<double, 3>{color.Red(), color.Green(), color.Blue()});
+    }
+
+    template <typename Enumeration>
+    void writeEnumeration(std::ostream& output, Enumeration value) {
+        writeValue(output, static_cast<std::uint32_t>(value));
+    }
+
+    void writeFlag(std::ostream& output, bool value) {
+        writeValue(output, static_cast<std::uint8_t>(value));
+    }
+
+    bool read(BinaryReader& reader, Vector& vector) {
+        std::array<double, 3> values;
+        if (! reader.read(values))
+            return false;
+
+        vector = Vector(values[0], values[1], values[2]);
+        return true;
+    }
+
+    bool read(BinaryReader& reader, Color& color) {
+        std::array<double, 3> values;
+        if (! reader.read(values))
+            return false;
+
+        color.set(values[0], values[1], values[2]);
+        return true;
+    }
+
+    bool readFlag(BinaryReader& reader, bool& value) {
+        std::uint8_t byte;
+        if (! reader.read(byte) || byte > 1)
+            return false;
+
+        value = byte == 1;
+        return true;
+    }
+
+    template <typename Enumeration>
+    bool readEnumeration(BinaryReader& reader, Enumeration& value, std::uint32_t count) {
+        std::uint32_t number;
+        if (! reader.read(number) || number >= count)
+            return false;
+
+        value = static_cast<Enumeration>(number);
+        return true;
+    }
+
+    void writeSettings(std::ostream& output, const SceneSettings& settings) {
+        writeEnumeration(output, settings.RenderMode);
+        writeValue(output, settings.MaxIterations);
+        writeValue(output, settings.Near);
+        writeValue(output, settings.Far);
+        writeFlag(output, settings.SoftShadows);
+        const GoochIlluminationModel& gooch = settings.Gooch;
+        writeValue(output, std::array<double, 4>{gooch.b, gooch.y, gooch.alpha, gooch.beta});
+
+        write(output, settings.Camera.Eye);
+        write(output, settings.Camera.Center);
+        write(output, settings.Camera.Up);
+        writeValue(output, settings.Camera.ViewSize);
+
+        writeValue(output, settings.SuperSamplingFactor);
+        writeFlag(output, settings.AdaptiveSuperSampling);
+        writeValue(output, settings.SuperSamplingThreshold);
+        writeValue(output, settings.ShadowEdgePrecision);
+        writeValue(output, settings.ShadowShadePrecision);
+
+        writeFlag(output, settings.RefractedShadows.has_value());
+        if (settings.RefractedShadows) {
+            const RefractedShadowsParameters& parameters = *settings.RefractedShadows;
+            writeValue(output, parameters.textureSize);
+            writeValue(output, std::array<double, 3>{parameters.smoothingFactor, parameters.precision, parameters.intensityFactor});
+        }
+    }
+
+    bool readSettings(BinaryReader& reader, SceneSettings& settings) {
+        bool hasRefractedShadows;
+        std::array<double, 4> gooch{};
+        bool isOk = readEnumeration(reader, settings.RenderMode, Mode::TEXTURE + 1)
+                && reader.read(settings.MaxIterations) && reader.read(settings.Near) && reader.read(settings.Far)
+                && readFlag(reader, settings.SoftShadows) && reader.read(gooch)
+                && read(reader, settings.Camera.Eye) && read(reader, settings.Camera.Center)
+                && read(reader, settings.Camera.Up) && reader.read(settings.Camera.ViewSize)
+                && reader.read(settings.SuperSamplingFactor) && readFlag(reader, settings.AdaptiveSuperSampling)
+                && reader.read(settings.SuperSamplingThreshold)
+                && reader.read(settings.ShadowEdgePrecision) && reader.read(settings.ShadowShadePrecision)
+                && readFlag(reader, hasRefractedShadows);
+
+        if (isOk)
+            settings.Gooch = GoochIlluminationModel{gooch[0], gooch[1], gooch[2], gooch[3]};
+
+        if (isOk && hasRefractedShadows) {
+            RefractedShadowsParameters& parameters = settings.RefractedShadows.emplace();
+            std::array<double, 3> values{};
+            isOk = reader.read(parameters.textureSize) && reader.read(values);
+            if (isOk) {
+                parameters.smoothingFactor = values[0];
+                parameters.precision = values[1];
+                parameters.intensityFactor = values[2];
+            }
+        }
+
+        return isOk;
+    }
+
+    void writeMaterial(std::ostream& output, const MaterialDescription& material) {
+        write(output, material.color);
+        writeString(output, material.texture);
+        writeString(output, material.specularMap);
+        writeString(output, material.normalMap);
+        writeValue(output, std::array<double, 5>{material.ka, material.kd, material.ks, material.n, material.index});
+        writeEnumeration(output, material.type);
+    }
+
+    bool readMaterial(BinaryReader& reader, MaterialDescription& material) {
+        std::array<double, 5> coefficients;
+        if (! read(reader, material.color)
+                || ! reader.readString(material.texture) || ! reader.readString(material.specularMap)
+                || ! reader.readString(material.normalMap)
+                || ! reader.read(coefficients) || ! readEnumeration(reader, material.type, MaterialType::REFRACTION + 1))
+            return false;
+
+        material.ka = coefficients[0];
+        material.kd = coefficients[1];
+        material.ks = coefficients[2];
+        material.n = coefficients[3];
+        material.index = coefficients[4];
+        return true;
+    }
+}
+
+bool SceneDescription::isCompiled(const std::string& fileName) {
+    char magic[sizeof(Magic)];
+    std::ifstream input{fileName, std::ios::binary};
+    return input.read(magic, sizeof(magic)) && std::equal(std::begin(magic), std::end(magic), Magic);
+}
+
+SceneDescription SceneDescription::readCompiled(const std::string& fileName) {
+    MappedFile file{fileName};
+    if (! file.isOpen())
+        throw std::runtime_error("File not found: " + fileName);
+
+    BinaryReader reader{file.data(), file.size()};
+    SceneDescription output;
+    char magic[sizeof(Magic)];
+    std::uint64_t count = 0;
+
+    bool isOk = reader.read(magic) && std::equal(std::begin(magic), std::end(magic), Magic)
+            && readSettings(reader, output.Settings) && reader.read(count);
+
+    // A count past the end of a truncated file stops at the first record it can not read
+    for (std::uint64_t i = 0; isOk && i < count; ++i)
+        isOk = readMaterial(reader, output.Materials.emplace_back());
+
+    isOk = isOk && reader.read(count);
+    for (std::uint64_t i = 0; isOk && i < count; ++i) {
+        ObjectDescription& object = output.Objects.emplace_back();
+        isOk = readEnumeration(reader, object.Type, std::size(ValueCountsOf));
+
+        const ValueCounts& counts = ValueCountsOf[isOk ? static_cast<std::size_t>(object.Type) : 0];
+        for (std::size_t j = 0; isOk && j < counts.Vectors; ++j)
+            isOk = read(reader, object.Vectors[j]);
+        for (std::size_t j = 0; isOk && j < counts.Numbers; ++j)
+            isOk = reader.read(object.Numbers[j]);
+
+        if (isOk && object.Type == ObjectType::TriangleAggregate)
+            isOk = reader.readString(object.FileName);
+
+        isOk = isOk && reader.read(object.Material) && object.Material < output.Materials.size();
+    }
+
+    isOk = isOk && reader.read(count);
+    for (std::uint64_t i = 0; isOk && i < count; ++i) {
+        LightDescription& light = output.Lights.emplace_back();
+        isOk = read(reader, light.Position) && read(reader, light.color) && reader.read(light.Size);
+    }
+
+    if (! isOk || ! reader.isAtEnd())
+        throw std::runtime_error("Invalid compiled scene file " + fileName);
+
+    return output;
+}
+
+void SceneDescription::writeCompiled(const std::string& fileName) const {
+    // The materials written once, every object referencing the first one equal to its own
+    std::vector<std::uint32_t> materialIndices(Materials.size());
+    std::vector<std::string> uniqueMaterials;
+    std::unordered_map<std::string, std::uint32_t> indexOf;
+
+    for (std::size_t i = 0; i < Materials.size(); ++i) {
+        std::ostringstream bytes;
+        writeMaterial(bytes, Materials[i]);
+
+        auto [iterator, isNew] = indexOf.try_emplace(bytes.str(), static_cast<std::uint32_t>(uniqueMaterials.size()));
+        if (isNew)
+            uniqueMaterials.push_back(iterator->first);
+        materialIndices[i] = iterator->second;
+    }
+
+    std::ofstream output{fileName, std::ios::binary};
+    output.write(Magic, sizeof(Magic));
+    writeSettings(output, Settings);
+
+    writeValue(output, static_cast<std::uint64_t>(uniqueMaterials.size()));
+    for (const std::string& material : uniqueMaterials)
+        output.write(material.data(), static_cast<std::streamsize>(material.size()));
+
+    writeValue(output, static_cast<std::uint64_t>(Objects.size()));
+    for (const ObjectDescription& object : Objects) {
+        const ValueCounts& counts = ValueCountsOf[static_cast<std::size_t>(object.Type)];
+
+        writeEnumeration(output, object.Type);
+        for (std::size_t j = 0; j < counts.Vectors; ++j)
+            write(output, object.Vectors[j]);
+        for (std::size_t j = 0; j < counts.Numbers; ++j)
+            writeValue(output, object.Numbers[j]);
+        if (object.Type == ObjectType::TriangleAggregate)
+            writeString(output, object.FileName);
+        writeValue(output, materialIndices[object.Material]);
+    }
+
+    writeValue(output, static_cast<std::uint64_t>(Lights.size()));
+    for (const LightDescription& light : Lights) {
+        write(output, light.Position);
+        write(output, light.color);
+        writeValue(output, light.Size);
+    }
+
+    output.close();
+    if (! output)
+        throw std::runtime_error("Unable to write the compiled scene file " + fileName);
+}
@@ -0,0 +1,101 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_SCENEDESCRIPTION_H
+#define RAYTRACER_SCENEDESCRIPTION_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "triple.h"
+#include "material.h"
+#include "scene.h"
+
+enum class ObjectType : std::uint32_t { Sphere, Cone, Plane, Triangle, TriangleAggregate, Quadrilateral, Box };
+
+// Material of a scene file, the textures being given by their file names
+struct MaterialDescription {
+    Color color;
+    std::string texture, specularMap, normalMap;
+    double ka = 0, kd = 0, ks = 0, n = 0;
+    double index = 1;
+    MaterialType type = MaterialType::DEFAULT;
+};
+
+/*
+ * Object of a scene file, with the values given to the constructor of its type:
+ *  - Sphere: Vectors = {position}, Numbers = {radius, quaternion x, y, z, w}
+ *  - Cone: Vectors = {position, side, up}
+ *  - Plane: Vectors = {position, normal}, Numbers = {UV scale}
+ *  - Triangle: Vectors = {corner 1, corner 2, corner 3}, Numbers = {U1, V1, U2, V2, U3, V3}
+ *  - TriangleAggregate: FileName of the OBJ file
+ *  - Quadrilateral: Vectors = {position, up, side}
+ *  - Box: Vectors = {position, up, side}, Numbers = {depth}
+ */
+struct ObjectDescription {
+    ObjectType Type = ObjectType::Sphere;
+    std::array<Vector, 3> Vectors{};
+    std::array<double, 6> Numbers{};
+    std::string FileName;
+    // Index in SceneDescription::Materials
+    std::uint32_t Material = 0;
+};
+
+struct LightDescription {
+    Point Position;
+    Color color;
+    float Size = 200;
+};
+
+// Parameters of the Camera, the default ones being those of a scene giving only its Eye
+struct CameraDescription {
+    Point Eye{200, 200, 0};
+    Point Center{200, 200, -200};
+    Vector Up{0, 1, 0};
+    std::array<unsigned int, 2> ViewSize = {400, 400};
+};
+
+// Settings of a scene file, everything but its objects and lights
+struct SceneSettings {
+    Mode RenderMode = Mode::PHONG;
+    int MaxIterations = 0;
+    int Near = 0, Far = 10000;
+    bool SoftShadows = false;
+    GoochIlluminationModel Gooch;
+
+    CameraDescription Camera;
+
+    unsigned int SuperSamplingFactor = 1;
+    bool AdaptiveSuperSampling = false;
+    double SuperSamplingThreshold = 0.1;
+    unsigned int ShadowEdgePrecision = 2, ShadowShadePrecision = 3;
+    std::optional<RefractedShadowsParameters> RefractedShadows;
+};
+
+/*
+ * Contents of a scene file, read from YAML or from a compiled scene file, before the objects are built.
+ *
+ * A compiled scene file holds the same values in binary: the settings, the table of the materials (a material shared
+ * by several objects being stored once), then the objects, with only the values of their type, and the lights.
+ * Loading it is reading numbers, without the YAML parser. The file names of the textures and of the OBJ files are kept
+ * as they are in the YAML file.
+ */
+struct SceneDescription {
+    SceneSettings Settings;
+    std::vector<MaterialDescription> Materials;
+    std::vector<ObjectDescription> Objects;
+    std::vector<LightDescription> Lights;
+
+    // Whether the file starts like a compiled scene file
+    static bool isCompiled(const std::string& fileName);
+    // Throws a std::runtime_error if the file can not be read or is not a compiled scene file
+    static SceneDescription readCompiled(const std::string& fileName);
+    // Throws a std::runtime_error if the file can not be written
+    void writeCompiled(const std::string& fileName) const;
+};
+
+
+#endif //RAYTRACER_SCENEDESCRIPTION_H
@@ -0,0 +1,143 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_SIMD4_H
+#define RAYTRACER_SIMD4_H
+
+#include <cstddef>
+#include <cstring>
+
+// Precision of Vector and Color, selected with the RAYTRACER_SINGLE_PRECISION CMake option
+#ifdef RAYTRACER_SINGLE_PRECISION
+typedef float Scalar;
+#else
+typedef double Scalar;
+#endif
+
+/*
+ * Four lanes of T processed together: the storage of Vector and Color, their fourth lane being padding.
+ *
+ * With GCC and Clang the lanes are a vector extension type, compiled to SSE/AVX (or NEON) instructions: two SSE2
+ * instructions per operation for doubles, one for floats. Other compilers get a plain loop over the lanes.
+ */
+template <typename T>
+class Simd4 {
+public:
+
+    static constexpr std::size_t Alignment = 4 * sizeof(T);
+
+#if defined(__GNUC__)
+    typedef T Native __attribute__((vector_size(4 * sizeof(T))));
+    // Two lanes, a half of Native
+    typedef T Half __attribute__((vector_size(2 * sizeof(T))));
+#else
+    struct Native {
+        T lanes[4];
+
+        T& operator[](std::size_t i) { return lanes[i]; }
+        T operator[](std::size_t i) const { return lanes[i]; }
+    };
+#endif
+
+    Simd4() = default;
+
+#if defined(__GNUC__)
+    Simd4(T x, T y, T z, T w) {
+        if constexpr (sizeof(Native) > 16) {
+            // Built by halves of 16 bytes: GCC builds a wider vector on the stack, lane by lane, and its loads stall
+            // on the stores of the lanes
+            Half halves[2] = {Half{x, y}, Half{z, w}};
+            std::memcpy(&value, halves, sizeof(Native));
+        }
+        else {
+            value = Native{x, y, z, w};
+        }
+    }
+#else
+    Simd4(T x, T y, T z, T w) : value{x, y, z, w}
+    { }
+#endif
+
+    explicit Simd4(const Native& native) : value(native)
+    { }
+
+    // The lanes from 4 aligned values
+    static Simd4 load(const T* values) {
+        Simd4 output;
+        std::memcpy(&output.value, values, sizeof(Native));
+        return output;
+    }
+
+    void store(T* values) const {
+        std::memcpy(values, &value, sizeof(Native));
+    }
+
+    T operator[](std::size_t i) const { return value[i]; }
+
+    // Sum of the first three lanes, in order
+    [[nodiscard]] T sum3() const { return value[0] + value[1] + value[2]; }
+
+    // Every lane brought in [minimum, maximum], the NaNs being kept
+    [[nodiscard]] Simd4 clamp(T minimum, T maximum) const {
+#if defined(__GNUC__)
+        if constexpr (sizeof(Native) > 16) {
+            // Clamped by halves of 16 bytes: without AVX, GCC compares the lanes of a wider vector one by one, going
+            // through the stack
+            Half halves[2];
+            std::memcpy(halves, &value, sizeof(Native));
+            halves[0] = clampLanes(halves[0], minimum, maximum);
+            halves[1] = clampLanes(halves[1], minimum, maximum);
+
+            Simd4 output;
+            std::memcpy(&output.value, halves, sizeof(Native));
+            return output;
+        }
+        else {
+            return Simd4{clampLanes(value, minimum, maximum)};
+        }
+#else
+        Simd4 output{*this};
+        for (std::size_t i = 0; i < 4; ++i)
+            output.value[i] = value[i] < minimum ? minimum : (value[i] > maximum ? maximum : value[i]);
+        return output;
+#endif
+    }
+
+#if defined(__GNUC__)
+    friend Simd4 operator+(const Simd4& a, const Simd4& b) { return Simd4{a.value + b.value}; }
+    friend Simd4 operator-(const Simd4& a, const Simd4& b) { return Simd4{a.value - b.value}; }
+    friend Simd4 operator*(const Simd4& a, const Simd4& b) { return Simd4{a.value * b.value}; }
+    friend Simd4 operator/(const Simd4& a, const Simd4& b) { return Simd4{a.value / b.value}; }
+    friend Simd4 operator-(const Simd4& a) { return Simd4{-a.value}; }
+#else
+    friend Simd4 operator+(const Simd4& a, const Simd4& b) { return apply(a, b, [] (T x, T y) { return x + y; }); }
+    friend Simd4 operator-(const Simd4& a, const Simd4& b) { return apply(a, b, [] (T x, T y) { return x - y; }); }
+    friend Simd4 operator*(const Simd4& a, const Simd4& b) { return apply(a, b, [] (T x, T y) { return x * y; }); }
+    friend Simd4 operator/(const Simd4& a, const Simd4& b) { return apply(a, b, [] (T x, T y) { return x / y; }); }
+    friend Simd4 operator-(const Simd4& a) { return Simd4{} - a; }
+#endif
+
+private:
+
+#if defined(__GNUC__)
+    template <typename Lanes>
+    static Lanes clampLanes(const Lanes& lanes, T minimum, T maximum) {
+        Lanes low = lanes < minimum ? Lanes{} + minimum : lanes;
+        return low > maximum ? Lanes{} + maximum : low;
+    }
+#else
+    template <typename Operation>
+    static Simd4 apply(const Simd4& a, const Simd4& b, Operation&& operation) {
+        Simd4 output;
+        for (std::size_t i = 0; i < 4; ++i)
+            output.value[i] = operation(a.value[i], b.value[i]);
+        return output;
+    }
+#endif
+
+    Native value{};
+};
+
+
+#endif //RAYTRACER_SIMD4_H
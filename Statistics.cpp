@@ -0,0 +1,168 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "Statistics.h"
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace Statistics {
+    namespace {
+        constexpr const char* CounterNames[] = {
+                "primary", "reflection", "refraction", "shadow",
+                "sphere", "cone", "triangle", "quadrilateral", "plane", "box", "mesh", "mesh_triangle",
+                "texture_lookups", "texture_page_hits", "texture_page_misses"
+        };
+        constexpr const char* PhaseNames[] = {
+                "yaml_parse", "compiled_scene_read", "asset_load", "obj_load", "hierarchy_build", "refracted_shadows", "smoothing", "tracing", "png_encode"
+        };
+
+        static_assert(std::size(CounterNames) == static_cast<std::size_t>(Counter::Count));
+        static_assert(std::size(PhaseNames) == static_cast<std::size_t>(Phase::Count));
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<const Counts*> runningThreads;
+            Counts endedThreads{};
+            std::size_t threadCount = 0;
+            std::array<std::chrono::duration<double>, static_cast<std::size_t>(Phase::Count)> phaseTimes{};
+        };
+
+        Registry& registry() {
+            static Registry instance;
+            return instance;
+        }
+
+        struct ThreadCounts {
+            Counts counts{};
+
+            ThreadCounts() {
+                Registry& shared = registry();
+                std::lock_guard<std::mutex> lock{shared.mutex};
+                shared.runningThreads.push_back(&counts);
+                shared.threadCount++;
+            }
+
+            ~ThreadCounts() {
+                Registry& shared = registry();
+                std::lock_guard<std::mutex> lock{shared.mutex};
+                for (std::size_t i = 0; i < counts.size(); ++i)
+                    shared.endedThreads[i] += counts[i];
+                shared.runningThreads.erase(std::find(shared.runningThreads.begin(), shared.runningThreads.end(), &counts));
+            }
+        };
+
+        thread_local PhaseTimer* currentTimer = nullptr;
+        thread_local bool untimed = false;
+
+        std::uint64_t countOf(const Counts& counts, Counter counter) {
+            return counts[static_cast<std::size_t>(counter)];
+        }
+    }
+
+    Counts& threadCounts() {
+        thread_local ThreadCounts counts;
+        return counts.counts;
+    }
+
+    Counts totalCounts() {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock{shared.mutex};
+
+        Counts output = shared.endedThreads;
+        for (const Counts* counts : shared.runningThreads) {
+            for (std::size_t i = 0; i < output.size(); ++i)
+                output[i] += (*counts)[i];
+        }
+
+        return output;
+    }
+
+    std::chrono::duration<double> phaseTime(Phase phase) {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock{shared.mutex};
+        return shared.phaseTimes[static_cast<std::size_t>(phase)];
+    }
+
+    PhaseTimer::PhaseTimer(Phase phase)
+        : phase(phase), start(std::chrono::steady_clock::now()), parent(currentTimer), recorded(! untimed)
+    {
+        if (recorded)
+            currentTimer = this;
+    }
+
+    PhaseTimer::~PhaseTimer() {
+        if (! recorded)
+            return;
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        currentTimer = parent;
+
+        if (parent != nullptr)
+            parent->nestedTime += elapsed;
+
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock{shared.mutex};
+        shared.phaseTimes[static_cast<std::size_t>(phase)] += elapsed - nestedTime;
+    }
+
+    UntimedScope::UntimedScope() : previous(untimed) {
+        untimed = true;
+    }
+
+    UntimedScope::~UntimedScope() {
+        untimed = previous;
+    }
+
+    void printPhases(std::ostream &output) {
+        output << "Phases:";
+        for (std::size_t i = 0; i < static_cast<std::size_t>(Phase::Count); ++i) {
+            double milliseconds = phaseTime(static_cast<Phase>(i)).count() * 1000;
+            if (milliseconds > 0)
+                output << " " << PhaseNames[i] << " " << milliseconds << " ms";
+        }
+        output << std::endl;
+    }
+
+    void writeJson(std::ostream &output) {
+        Counts counts = totalCounts();
+        std::size_t threadCount;
+        {
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock{shared.mutex};
+            threadCount = shared.threadCount;
+        }
+
+        auto writeCounters = [&output, &counts] (Counter first, Counter end, const char* indent) {
+            for (auto i = static_cast<std::size_t>(first); i < static_cast<std::size_t>(end); ++i) {
+                output << indent << "\"" << CounterNames[i] << "\": " << counts[i]
+                       << (i + 1 < static_cast<std::size_t>(end) ? ",\n" : "\n");
+            }
+        };
+
+        output << "{\n";
+        output << "  \"counters_enabled\": " << (Enabled ? "true" : "false") << ",\n";
+        output << "  \"counting_threads\": " << threadCount << ",\n";
+        output << "  \"rays\": {\n";
+        writeCounters(Counter::PrimaryRays, Counter::SphereTests, "    ");
+        output << "  },\n  \"intersection_tests\": {\n";
+        writeCounters(Counter::SphereTests, Counter::TextureLookups, "    ");
+        output << "  },\n";
+        output << "  \"texture_lookups\": " << countOf(counts, Counter::TextureLookups) << ",\n";
+
+        std::uint64_t pageHits = countOf(counts, Counter::TexturePageHits);
+        std::uint64_t pageMisses = countOf(counts, Counter::TexturePageMisses);
+        output << "  \"texture_pages\": {\n";
+        output << "    \"hits\": " << pageHits << ",\n";
+        output << "    \"misses\": " << pageMisses << ",\n";
+        output << "    \"hit_rate\": " << (pageHits + pageMisses > 0 ? static_cast<double>(pageHits) / (pageHits + pageMisses) : 0) << "\n";
+        output << "  },\n";
+        output << "  \"phases_ms\": {\n";
+        for (std::size_t i = 0; i < static_cast<std::size_t>(Phase::Count); ++i) {
+            output << "    \"" << PhaseNames[i] << "\": " << phaseTime(static_cast<Phase>(i)).count() * 1000
+                   << (i + 1 < static_cast<std::size_t>(Phase::Count) ? ",\n" : "\n");
+        }
+        output << "  }\n}" << std::endl;
+    }
+}
@@ -0,0 +1,112 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_STATISTICS_H
+#define RAYTRACER_STATISTICS_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+/*
+ * Render statistics: event counters and phase timings.
+ *
+ * The counters are kept per thread and merged when the report is made, so that counting costs a thread local
+ * increment. They are only compiled with RAYTRACER_STATISTICS defined (the RAYTRACER_STATISTICS CMake option):
+ * otherwise COUNT_STATISTIC expands to nothing. The phase timings are always recorded, a phase being timed
+ * once per render.
+ */
+namespace Statistics {
+
+    enum class Counter {
+        PrimaryRays, ReflectionRays, RefractionRays, ShadowRays,
+        SphereTests, ConeTests, TriangleTests, QuadrilateralTests, PlaneTests, BoxTests, MeshTests,
+        // Triangles of a mesh tested by the hierarchy kernels, counted by blocks of WideTriangleHierarchy::Width
+        MeshTriangleTests,
+        TextureLookups,
+        // Lookups of the textures read from tiled cache files, whose page was in the PagePool or read from the file
+        TexturePageHits, TexturePageMisses,
+        Count
+    };
+
+    enum class Phase {
+        YamlParse, CompiledSceneRead, AssetLoad, ObjLoad, HierarchyBuild, RefractedShadows, Smoothing, Tracing, PngEncode,
+        Count
+    };
+
+    constexpr bool Enabled =
+#ifdef RAYTRACER_STATISTICS
+            true;
+#else
+            false;
+#endif
+
+    using Counts = std::array<std::uint64_t, static_cast<std::size_t>(Counter::Count)>;
+
+    // Counts of the calling thread, merged in the totals when the thread ends
+    Counts& threadCounts();
+
+    inline void add(Counter counter, std::uint64_t count) {
+        threadCounts()[static_cast<std::size_t>(counter)] += count;
+    }
+
+    // Sum of the counts of every thread, running or ended
+    Counts totalCounts();
+    // Time spent in the phase, without the time of the phases nested in it
+    std::chrono::duration<double> phaseTime(Phase phase);
+
+    /*
+     * Adds the time of its scope to a phase. A timer created while another one runs on the same thread
+     * removes its time from the other one, a phase nested in another (OBJ load while parsing) being
+     * reported apart.
+     */
+    class PhaseTimer {
+    public:
+        explicit PhaseTimer(Phase phase);
+        ~PhaseTimer();
+
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    private:
+        Phase phase;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::duration<double> nestedTime{};
+        PhaseTimer* parent;
+        // False when created in an UntimedScope
+        bool recorded;
+    };
+
+    /*
+     * Leaves out the timers created on the calling thread during its scope. A pool of threads working inside a
+     * timed phase opens one: the timers of the workers have no parent to remove their time from, and running side
+     * by side their times would add up past the wall time. Their work is counted in the enclosing phase.
+     */
+    class UntimedScope {
+    public:
+        UntimedScope();
+        ~UntimedScope();
+
+        UntimedScope(const UntimedScope&) = delete;
+        UntimedScope& operator=(const UntimedScope&) = delete;
+
+    private:
+        bool previous;
+    };
+
+    void printPhases(std::ostream& output);
+    void writeJson(std::ostream& output);
+}
+
+#ifdef RAYTRACER_STATISTICS
+#define COUNT_STATISTIC(counter) Statistics::add(Statistics::Counter::counter, 1)
+#define ADD_STATISTIC(counter, count) Statistics::add(Statistics::Counter::counter, (count))
+#else
+#define COUNT_STATISTIC(counter) static_cast<void>(0)
+#define ADD_STATISTIC(counter, count) static_cast<void>(0)
+#endif
+
+
+#endif //RAYTRACER_STATISTICS_H
@@ -0,0 +1,77 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "Texture.h"
+#include <algorithm>
+#include <cmath>
+#include "TextureFile.h"
+
+Texture::Texture(TiledImage image) {
+    levels.push_back(std::move(image));
+
+    while (levels.back().width() > 1 || levels.back().height() > 1)
+        levels.push_back(halve(levels.back()));
+
+    texelSize = {1.0 / width(), 1.0 / height()};
+}
+
+Texture::Texture(const std::shared_ptr<const TextureFile>& file) {
+    for (std::size_t i = 0; i < file->levelCount(); ++i)
+        levels.emplace_back(file, i);
+
+    texelSize = {1.0 / width(), 1.0 / height()};
+}
+
+Color Texture::blendedColorAt(double u, double v, const std::array<double, 2>& footprint) const {
+    // Texels of the full image covered by the footprint on its longest side
+    double texels = std::max(footprint[0] * width(), footprint[1] * height());
+
+    if (! (texels > 1))
+        return levels.front().colorAt(u, v);
+
+    // texels = mantissa * 2^exponent, mantissa in [0.5, 1): the level of the texels as large as the footprint is
+    // between exponent - 1 and exponent, the weight of the upper level growing linearly with the footprint
+    int exponent;
+    double mantissa = std::frexp(texels, &exponent);
+    auto lowerLevel = static_cast<std::size_t>(exponent - 1);
+    if (lowerLevel + 1 >= levels.size())
+        return levels.back().colorAt(u, v);
+
+    double weight = 2 * mantissa - 1;
+    Radiance blend = Radiance{levels[lowerLevel].colorAt(u, v)} * (1 - weight)
+                     + Radiance{levels[lowerLevel + 1].colorAt(u, v)} * weight;
+    return blend.clamped();
+}
+
+std::size_t Texture::memoryUsage() const {
+    std::size_t output = 0;
+    for (const TiledImage& image : levels)
+        output += image.memoryUsage();
+
+    return output;
+}
+
+TiledImage Texture::halve(const TiledImage& image) {
+    int width = std::max(image.width() / 2, 1);
+    int height = std::max(image.height() / 2, 1);
+    TiledImage output{width, height, image.format()};
+
+    for (int y = 0; y < height; ++y) {
+        // An odd last row or column is left out, a side of 1 texel being kept
+        int y0 = std::min(2 * y, image.height() - 1), y1 = std::min(2 * y + 1, image.height() - 1);
+
+        for (int x = 0; x < width; ++x) {
+            int x0 = std::min(2 * x, image.width() - 1), x1 = std::min(2 * x + 1, image.width() - 1);
+
+            std::uint8_t* texel = output.texel(x, y);
+            for (std::size_t channel = 0; channel < image.channels(); ++channel) {
+                int sum = image.texel(x0, y0)[channel] + image.texel(x1, y0)[channel]
+                          + image.texel(x0, y1)[channel] + image.texel(x1, y1)[channel];
+                texel[channel] = static_cast<std::uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+
+    return output;
+}
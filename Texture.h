@@ -0,0 +1,62 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_TEXTURE_H
+#define RAYTRACER_TEXTURE_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "TiledImage.h"
+
+/*
+ * Texture image with its mip pyramid: every level is half the size of the previous one, down to 1 x 1 texel, each
+ * texel being the mean of the 2 x 2 texels it covers in the level above.
+ *
+ * A lookup is given the size of its footprint in texture coordinates (the ray cone of the ray hitting the textured
+ * surface), and reads the levels whose texels have that size: a minified texture is read in a small level instead
+ * of sampling a few texels of the full image, which aliases and goes through the whole image in the cache.
+ *
+ * The levels are in the format of the image they are built from, 8 bits per channel. They are in memory, or read on
+ * demand from the tiled cache file of the texture.
+ */
+class Texture {
+public:
+
+    explicit Texture(TiledImage image);
+    // The pyramid in the cache file
+    explicit Texture(const std::shared_ptr<const TextureFile>& file);
+
+    // Nearest texel of the two levels closest to the footprint (its extent along U and V), blended. A footprint below
+    // a texel reads the full image.
+    [[nodiscard]] Color colorAt(double u, double v, const std::array<double, 2>& footprint = {0, 0}) const {
+        // Footprint within a texel of the full image, the usual case of the magnified textures: read without
+        // choosing the levels
+        if (footprint[0] <= texelSize[0] && footprint[1] <= texelSize[1])
+            return levels.front().colorAt(u, v);
+        return blendedColorAt(u, v, footprint);
+    }
+
+    [[nodiscard]] const TiledImage& level(std::size_t i) const { return levels[i]; }
+    [[nodiscard]] std::size_t levelCount() const { return levels.size(); }
+    [[nodiscard]] int width() const { return levels.front().width(); }
+    [[nodiscard]] int height() const { return levels.front().height(); }
+
+    // Pixels of the full image and of the pyramid in memory, in bytes
+    [[nodiscard]] std::size_t memoryUsage() const;
+
+private:
+
+    static TiledImage halve(const TiledImage& image);
+
+    [[nodiscard]] Color blendedColorAt(double u, double v, const std::array<double, 2>& footprint) const;
+
+    std::vector<TiledImage> levels;
+    // Size of a texel of the full image in texture coordinates
+    std::array<double, 2> texelSize{};
+};
+
+
+#endif //RAYTRACER_TEXTURE_H
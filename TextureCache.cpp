@@ -0,0 +1,101 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "TextureCache.h"
+#include "TextureFile.h"
+
+namespace {
+    // Normalized absolute path of the file, and the format it is read in
+    std::string keyOf(const std::string& fileName, TexelFormat format) {
+        std::error_code error;
+        std::filesystem::path path = std::filesystem::absolute(fileName, error);
+        return (error ? fileName : path.lexically_normal().string()) + (format == TexelFormat::R8 ? ":R8" : ":RGBA8");
+    }
+}
+
+TextureCache& TextureCache::shared() {
+    static TextureCache cache;
+    return cache;
+}
+
+std::shared_ptr<const Texture> TextureCache::get(const std::string& fileName, TexelFormat format) {
+    std::string key = keyOf(fileName, format);
+    std::shared_ptr<const Texture> texture = decode(key, fileName, format);
+
+    std::lock_guard<std::mutex> lock{mutex};
+    requests++;
+
+    Entry& entry = textures[key];
+    if (entry.isUsed)
+        bytesSaved += texture->memoryUsage();
+    entry.texture = texture;
+    entry.isUsed = true;
+    return texture;
+}
+
+void TextureCache::preload(const std::string& fileName, TexelFormat format) {
+    decode(keyOf(fileName, format), fileName, format);
+}
+
+std::shared_ptr<const Texture> TextureCache::decode(const std::string& key, const std::string& fileName, TexelFormat format) {
+    std::filesystem::path directory;
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        auto found = textures.find(key);
+        if (found != textures.end())
+            return found->second.texture;
+        directory = cacheDirectory;
+    }
+
+    auto texture = directory.empty()
+            ? std::make_shared<const Texture>(TiledImage::read_png(fileName, format))
+            : std::make_shared<const Texture>(TextureFile::open(fileName, format, directory));
+
+    // The texture of a thread having decoded the same file meanwhile is kept, this one being dropped
+    std::lock_guard<std::mutex> lock{mutex};
+    return textures.try_emplace(key, Entry{texture}).first->second.texture;
+}
+
+void TextureCache::setCacheDirectory(const std::filesystem::path& directory) {
+    std::lock_guard<std::mutex> lock{mutex};
+    cacheDirectory = directory;
+}
+
+std::size_t TextureCache::uniqueTextureCount() const {
+    std::lock_guard<std::mutex> lock{mutex};
+    return textures.size();
+}
+
+std::size_t TextureCache::requestCount() const {
+    std::lock_guard<std::mutex> lock{mutex};
+    return requests;
+}
+
+std::size_t TextureCache::savedBytes() const {
+    std::lock_guard<std::mutex> lock{mutex};
+    return bytesSaved;
+}
+
+void TextureCache::printSummary(std::ostream& output) const {
+    std::lock_guard<std::mutex> lock{mutex};
+    if (requests == 0)
+        return;
+
+    std::size_t totalBytes = 0;
+    for (const auto& texture : textures)
+        totalBytes += texture.second.texture->memoryUsage();
+
+    output << "Textures: " << textures.size() << " unique for " << requests << " uses, "
+           << totalBytes / 1024 << " KiB of pixels with the mip pyramids, " << bytesSaved / 1024 << " KiB saved by sharing";
+    if (! cacheDirectory.empty())
+        output << ", the texels paged from the cache files in " << cacheDirectory.string();
+    output << std::endl;
+}
+
+void TextureCache::clear() {
+    std::lock_guard<std::mutex> lock{mutex};
+    textures.clear();
+    requests = 0;
+    bytesSaved = 0;
+}
@@ -0,0 +1,73 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_TEXTURECACHE_H
+#define RAYTRACER_TEXTURECACHE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include "Texture.h"
+
+/*
+ * Textures of the scene, shared between the materials: every file is decoded once and its mip pyramid built, the
+ * materials using it holding the same texture. The files are keyed by their normalized absolute path, so that "a.png" and "./a.png" are one texture,
+ * and by the format they are read in.
+ *
+ * With a cache directory, the textures are converted to tiled cache files there and read on demand through the
+ * PagePool, instead of being decoded into memory: for the scenes whose textures do not fit in memory.
+ *
+ * A file is decoded without the cache locked, several threads decoding different files at once.
+ */
+class TextureCache {
+public:
+
+    // Cache of the process, used by the scene reader
+    static TextureCache& shared();
+
+    // The texture of the PNG file in the format, decoded on its first request. Throws std::runtime_error if the file can
+    // not be read.
+    std::shared_ptr<const Texture> get(const std::string& fileName, TexelFormat format = TexelFormat::RGBA8);
+    // Decodes the texture before its first request, which is not counted as a use. Throws std::runtime_error if the file
+    // can not be read.
+    void preload(const std::string& fileName, TexelFormat format = TexelFormat::RGBA8);
+
+    [[nodiscard]] std::size_t uniqueTextureCount() const;
+    [[nodiscard]] std::size_t requestCount() const;
+    // Size of the pixels (pyramids included) that the requests of an already decoded texture would have copied
+    [[nodiscard]] std::size_t savedBytes() const;
+
+    // Directory of the tiled cache files of the textures read from then on, none to keep them in memory
+    void setCacheDirectory(const std::filesystem::path& directory);
+
+    // Prints the number of unique textures and the bytes saved, nothing when no texture was requested
+    void printSummary(std::ostream& output) const;
+
+    // Forgets the textures, the materials keeping theirs
+    void clear();
+
+private:
+
+    struct Entry {
+        std::shared_ptr<const Texture> texture;
+        // Whether it was given by get, the next requests sharing it
+        bool isUsed = false;
+    };
+
+    // The texture of the key, decoded if it is not in the cache yet
+    std::shared_ptr<const Texture> decode(const std::string& key, const std::string& fileName, TexelFormat format);
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> textures;
+    std::filesystem::path cacheDirectory;
+    std::size_t requests = 0;
+    std::size_t bytesSaved = 0;
+};
+
+
+#endif //RAYTRACER_TEXTURECACHE_H
@@ -0,0 +1,108 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "TextureFile.h"
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include "BinaryIO.h"
+#include "CacheFile.h"
+#include "Texture.h"
+
+namespace {
+    constexpr char Magic[8] = {'R', 'T', 'T', 'I', 'L', 'E', 'S', '2'};
+
+    std::atomic<std::uint64_t> nextId{1};
+}
+
+TextureFile::TextureFile(std::filesystem::path path, TexelFormat format)
+        : _path(std::move(path)), _format(format), _id(nextId++), stream(_path, std::ios::binary)
+{ }
+
+std::shared_ptr<const TextureFile> TextureFile::open(const std::string& fileName, TexelFormat format,
+                                                     const std::filesystem::path& directory) {
+    std::optional<CacheSource> source = CacheSource::of(fileName);
+    if (! source)
+        throw std::runtime_error("File not found: " + fileName);
+
+    std::filesystem::path path = directory / source->cacheFileName(format == TexelFormat::R8 ? ".r8.tiles" : ".rgba8.tiles");
+
+    std::shared_ptr<TextureFile> file{new TextureFile{path, format}};
+    if (file->readHeader(*source))
+        return file;
+
+    convert(*source, format, path);
+    file.reset(new TextureFile{path, format});
+    if (! file->readHeader(*source))
+        throw std::runtime_error("Unable to read the texture cache file " + path.string());
+
+    return file;
+}
+
+bool TextureFile::readHeader(const CacheSource& source) {
+    char magic[sizeof(Magic)];
+    if (! stream.read(magic, sizeof(magic)) || std::memcmp(magic, Magic, sizeof(Magic)) != 0)
+        return false;
+
+    std::uint32_t format, levelCount;
+    std::uint64_t size;
+    std::int64_t modificationTime;
+    std::string path;
+    if (! readValue(stream, format) || format != static_cast<std::uint32_t>(_format)
+            || ! readValue(stream, size) || size != source.size
+            || ! readValue(stream, modificationTime) || modificationTime != source.modificationTime
+            || ! readString(stream, path) || path != source.path || ! readValue(stream, levelCount))
+        return false;
+
+    std::size_t pageCount = 0;
+    for (std::uint32_t i = 0; i < levelCount; ++i) {
+        std::int32_t width, height;
+        if (! readValue(stream, width) || ! readValue(stream, height))
+            return false;
+
+        levels.push_back(Level{width, height, pageCount});
+        pageCount += TiledImage::pageCountOf(width, height);
+    }
+    pagesOffset = stream.tellg();
+
+    // A file cut short is converted again
+    stream.seekg(0, std::ios::end);
+    return stream && stream.tellg() >= pagesOffset + static_cast<std::streamoff>(pageCount * pageBytes());
+}
+
+void TextureFile::convert(const CacheSource& source, TexelFormat format, const std::filesystem::path& path) {
+    Texture texture{TiledImage::read_png(source.path, format)};
+
+    bool written = writeCacheFile(path, [&] (std::ostream& output) {
+        output.write(Magic, sizeof(Magic));
+        writeValue(output, static_cast<std::uint32_t>(format));
+        writeValue(output, source.size);
+        writeValue(output, source.modificationTime);
+        writeString(output, source.path);
+
+        writeValue(output, static_cast<std::uint32_t>(texture.levelCount()));
+        for (std::size_t i = 0; i < texture.levelCount(); ++i) {
+            writeValue(output, static_cast<std::int32_t>(texture.level(i).width()));
+            writeValue(output, static_cast<std::int32_t>(texture.level(i).height()));
+        }
+
+        for (std::size_t i = 0; i < texture.levelCount(); ++i) {
+            const TiledImage& level = texture.level(i);
+            output.write(reinterpret_cast<const char*>(level.bytes()), static_cast<std::streamsize>(level.pageCount() * level.pageBytes()));
+        }
+    });
+
+    if (! written)
+        throw std::runtime_error("Unable to write the texture cache file " + path.string());
+}
+
+void TextureFile::readPage(std::size_t page, std::uint8_t* output) const {
+    std::lock_guard<std::mutex> lock{mutex};
+
+    stream.seekg(pagesOffset + static_cast<std::streamoff>(page * pageBytes()));
+    if (! stream.read(reinterpret_cast<char*>(output), static_cast<std::streamsize>(pageBytes()))) {
+        stream.clear();
+        throw std::runtime_error("Unable to read the texture cache file " + _path.string());
+    }
+}
@@ -0,0 +1,79 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_TEXTUREFILE_H
+#define RAYTRACER_TEXTUREFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "CacheFile.h"
+#include "TiledImage.h"
+
+/*
+ * Texture converted once into a tiled cache file: the levels of its mip pyramid one after the other, in the pages of
+ * TiledImage. The renders read the pages on demand through the PagePool, instead of keeping the whole texture in
+ * memory.
+ *
+ * The cache files are in a cache directory, named after the path of the PNG file and the format. A cache file is
+ * written again when the size or the modification time of its PNG file changes.
+ */
+class TextureFile {
+public:
+
+    // The cache file of the PNG file in the format, converted first if it is missing or out of date. Throws
+    // std::runtime_error if the PNG file or the cache file can not be read, or the cache file written.
+    static std::shared_ptr<const TextureFile> open(const std::string& fileName, TexelFormat format,
+                                                   const std::filesystem::path& directory);
+
+    TextureFile(const TextureFile&) = delete;
+    TextureFile& operator=(const TextureFile&) = delete;
+
+    [[nodiscard]] TexelFormat format() const { return _format; }
+    [[nodiscard]] std::size_t levelCount() const { return levels.size(); }
+    [[nodiscard]] int width(std::size_t level) const { return levels[level].width; }
+    [[nodiscard]] int height(std::size_t level) const { return levels[level].height; }
+    // Index in the file of the first page of the level
+    [[nodiscard]] std::size_t firstPage(std::size_t level) const { return levels[level].firstPage; }
+    [[nodiscard]] std::size_t pageBytes() const { return TiledImage::PageTexels * TiledImage::channelsOf(_format); }
+
+    // Key of the file in the PagePool, unique in the process
+    [[nodiscard]] std::uint64_t id() const { return _id; }
+    [[nodiscard]] const std::filesystem::path& path() const { return _path; }
+
+    // Copies the page into output, pageBytes() bytes. Throws std::runtime_error if the file can not be read.
+    void readPage(std::size_t page, std::uint8_t* output) const;
+
+private:
+
+    struct Level {
+        int width;
+        int height;
+        std::size_t firstPage;
+    };
+
+    TextureFile(std::filesystem::path path, TexelFormat format);
+
+    // Reads the header of the cache file, false if it is not the cache file of the source in the format
+    bool readHeader(const CacheSource& source);
+    static void convert(const CacheSource& source, TexelFormat format, const std::filesystem::path& path);
+
+    std::filesystem::path _path;
+    TexelFormat _format;
+    std::uint64_t _id;
+    std::vector<Level> levels;
+    // Offset of the first page in the file
+    std::streamoff pagesOffset = 0;
+
+    mutable std::mutex mutex;
+    mutable std::ifstream stream;
+};
+
+
+#endif //RAYTRACER_TEXTUREFILE_H
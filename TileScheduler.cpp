@@ -0,0 +1,152 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "TileScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace {
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::size_t> tiles;
+
+        std::optional<std::size_t> popFront() {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (tiles.empty())
+                return std::nullopt;
+
+            std::size_t tile = tiles.front();
+            tiles.pop_front();
+            return tile;
+        }
+
+        std::optional<std::size_t> popBack() {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (tiles.empty())
+                return std::nullopt;
+
+            std::size_t tile = tiles.back();
+            tiles.pop_back();
+            return tile;
+        }
+    };
+}
+
+TileScheduler::TileScheduler(int imageWidth, int imageHeight, int tileSize, unsigned int threadCount)
+    : workerCount(threadCount > 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency()))
+{
+    tileSize = std::max(tileSize, 1);
+
+    for (int y = 0; y < imageHeight; y += tileSize) {
+        for (int x = 0; x < imageWidth; x += tileSize) {
+            tiles.push_back({x, y, std::min(tileSize, imageWidth - x), std::min(tileSize, imageHeight - y)});
+        }
+    }
+
+    timings.resize(tiles.size());
+}
+
+void TileScheduler::run(const std::function<void(const Tile &)> &renderTile) {
+    run(renderTile, 0, std::numeric_limits<int>::max());
+}
+
+void TileScheduler::run(const std::function<void(const Tile &)> &renderTile, int firstRow, int endRow) {
+    // The tiles being sorted by row, those of the rows form a contiguous range
+    auto first = std::find_if(tiles.begin(), tiles.end(), [firstRow] (const Tile& tile) { return tile.Y >= firstRow; });
+    auto end = std::find_if(first, tiles.end(), [endRow] (const Tile& tile) { return tile.Y >= endRow; });
+    std::size_t firstTile = first - tiles.begin();
+    std::size_t tileCount = end - first;
+
+    if (tileCount == 0)
+        return;
+
+    std::vector<WorkQueue> queues(workerCount);
+
+    // Contiguous runs of tiles, the neighbouring tiles sharing the same objects
+    for (std::size_t tile = 0; tile < tileCount; ++tile)
+        queues[tile * workerCount / tileCount].tiles.push_back(firstTile + tile);
+
+    std::atomic<std::size_t> stolen{0};
+
+    auto work = [this, &queues, &stolen, &renderTile] (unsigned int worker) {
+        while (true) {
+            std::optional<std::size_t> tile = queues[worker].popFront();
+
+            // No tile is added during the run, so a worker finding every queue empty is done
+            for (unsigned int i = 1; i < workerCount && ! tile.has_value(); ++i) {
+                tile = queues[(worker + i) % workerCount].popBack();
+                if (tile.has_value())
+                    stolen++;
+            }
+
+            if (! tile.has_value())
+                return;
+
+            auto start = std::chrono::steady_clock::now();
+            renderTile(tiles[*tile]);
+            std::chrono::duration<double, std::milli> tileTime = std::chrono::steady_clock::now() - start;
+
+            timings[*tile].Thread = worker;
+            timings[*tile].Milliseconds += tileTime.count();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int worker = 1; worker < workerCount; ++worker)
+        threads.emplace_back(work, worker);
+
+    work(0);
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    stolenTileCount += stolen;
+}
+
+void TileScheduler::printSummary(std::ostream &output) const {
+    if (tiles.empty())
+        return;
+
+    std::vector<double> busyTimes(workerCount, 0);
+    std::vector<std::size_t> tileCounts(workerCount, 0);
+    double slowestTile = 0, totalTime = 0;
+
+    for (const TileTiming& timing : timings) {
+        busyTimes[timing.Thread] += timing.Milliseconds;
+        tileCounts[timing.Thread]++;
+        slowestTile = std::max(slowestTile, timing.Milliseconds);
+        totalTime += timing.Milliseconds;
+    }
+
+    auto [leastBusy, mostBusy] = std::minmax_element(busyTimes.begin(), busyTimes.end());
+
+    output << "Tiles: " << tiles.size() << " of " << tiles.front().Width << "x" << tiles.front().Height << " pixels on "
+           << workerCount << " threads, " << stolenTileCount << " stolen" << std::endl;
+    output << "  tile time: " << totalTime / tiles.size() << " ms on average, " << slowestTile << " ms at most" << std::endl;
+    output << "  thread busy time: " << *leastBusy << " to " << *mostBusy << " ms, "
+           << *std::min_element(tileCounts.begin(), tileCounts.end()) << " to "
+           << *std::max_element(tileCounts.begin(), tileCounts.end()) << " tiles per thread" << std::endl;
+}
+
+bool TileScheduler::writeTimings(const std::string &fileName) const {
+    std::ofstream output{fileName};
+    if (! output)
+        return false;
+
+    output << "x,y,width,height,thread,milliseconds" << std::endl;
+    for (std::size_t i = 0; i < tiles.size(); ++i) {
+        output << tiles[i].X << "," << tiles[i].Y << "," << tiles[i].Width << "," << tiles[i].Height << ","
+               << timings[i].Thread << "," << timings[i].Milliseconds << std::endl;
+    }
+
+    return true;
+}
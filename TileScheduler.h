@@ -0,0 +1,63 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_TILESCHEDULER_H
+#define RAYTRACER_TILESCHEDULER_H
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct Tile {
+    int X, Y;
+    int Width, Height;
+};
+
+struct TileTiming {
+    unsigned int Thread;
+    double Milliseconds;
+};
+
+/*
+ * Splits an image in square tiles rendered by a pool of worker threads.
+ *
+ * The tiles are first dealt to the workers in contiguous runs, each worker having its own queue. A worker renders the
+ * tiles of its queue from the front, and once it is empty steals tiles from the back of the queue of another worker.
+ * The expensive regions of the image (reflections, refractions) are thus shared between the threads at the end
+ * of the render, whatever their position.
+ *
+ * The tiles cover disjoint regions of the image, they can be written without synchronisation.
+ */
+class TileScheduler {
+public:
+
+    // threadCount at 0 uses one thread per hardware thread
+    TileScheduler(int imageWidth, int imageHeight, int tileSize, unsigned int threadCount);
+
+    // Calls renderTile for every tile, from the worker threads
+    void run(const std::function<void(const Tile&)>& renderTile);
+    // Calls renderTile for the tiles starting in the rows [firstRow, endRow) only
+    void run(const std::function<void(const Tile&)>& renderTile, int firstRow, int endRow);
+
+    [[nodiscard]] unsigned int threadCount() const { return workerCount; }
+    [[nodiscard]] const std::vector<Tile>& getTiles() const { return tiles; }
+    // Time taken by each tile over the runs, and the thread of its last run, in the order of getTiles
+    [[nodiscard]] const std::vector<TileTiming>& getTimings() const { return timings; }
+    [[nodiscard]] std::size_t getStolenTileCount() const { return stolenTileCount; }
+
+    void printSummary(std::ostream& output) const;
+    // One line per tile: position, size, thread and time, as comma separated values
+    bool writeTimings(const std::string& fileName) const;
+
+private:
+
+    std::vector<Tile> tiles;
+    std::vector<TileTiming> timings;
+    unsigned int workerCount;
+    std::size_t stolenTileCount = 0;
+};
+
+
+#endif //RAYTRACER_TILESCHEDULER_H
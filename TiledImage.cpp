@@ -0,0 +1,81 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "TiledImage.h"
+#include <cmath>
+#include <stdexcept>
+#include "lodepng.h"
+#include "PagePool.h"
+#include "TextureFile.h"
+
+namespace {
+    std::uint8_t channelByte(double component) {
+        return static_cast<std::uint8_t>(std::lround(component * 255));
+    }
+}
+
+TiledImage::TiledImage(int width, int height, TexelFormat format)
+        : _width(width), _height(height), _format(format), tileShift(format == TexelFormat::RGBA8 ? 2 : 3),
+          pagesPerRow(static_cast<std::size_t>((width + PageSide - 1) / PageSide)),
+          pageRows(static_cast<std::size_t>((height + PageSide - 1) / PageSide))
+{
+    tiles.resize(pageCount() * pageBytes() / sizeof(Tile));
+}
+
+TiledImage::TiledImage(std::shared_ptr<const TextureFile> file, std::size_t level)
+        : _width(file->width(level)), _height(file->height(level)), _format(file->format()),
+          tileShift(_format == TexelFormat::RGBA8 ? 2 : 3),
+          pagesPerRow(static_cast<std::size_t>((_width + PageSide - 1) / PageSide)),
+          pageRows(static_cast<std::size_t>((_height + PageSide - 1) / PageSide)),
+          firstPage(file->firstPage(level))
+{
+    this->file = std::move(file);
+}
+
+std::size_t TiledImage::pageCountOf(int width, int height) {
+    return static_cast<std::size_t>((width + PageSide - 1) / PageSide) * static_cast<std::size_t>((height + PageSide - 1) / PageSide);
+}
+
+TiledImage::TiledImage(const Image& image, TexelFormat format)
+        : TiledImage(image.width(), image.height(), format)
+{
+    for (int y = 0; y < _height; ++y) {
+        for (int x = 0; x < _width; ++x) {
+            std::uint8_t* output = texel(x, y);
+            for (std::size_t channel = 0; channel < colorChannels(); ++channel)
+                output[channel] = channelByte(image(x, y)[channel]);
+        }
+    }
+}
+
+TiledImage TiledImage::read_png(const std::string& fileName, TexelFormat format) {
+    std::vector<unsigned char> buffer, image;
+    LodePNG::loadFile(buffer, fileName);
+    if (buffer.empty())
+        throw std::runtime_error("File not found: " + fileName);
+
+    LodePNG::Decoder decoder;
+    decoder.decode(image, &buffer[0], (unsigned)buffer.size());
+    if (decoder.hasError() || decoder.getChannels() < 3 || decoder.getBpp() < 24)
+        throw std::runtime_error("Only color (RGBA), 8 bit per channel png images are supported: " + fileName);
+
+    // The decoded texels are in RGBA, the alpha channel being left out as by Image::read_png
+    TiledImage output{static_cast<int>(decoder.getWidth()), static_cast<int>(decoder.getHeight()), format};
+    auto decoded = image.begin();
+    for (int y = 0; y < output.height(); ++y) {
+        for (int x = 0; x < output.width(); ++x, decoded += 4) {
+            std::uint8_t* texel = output.texel(x, y);
+            for (std::size_t channel = 0; channel < output.colorChannels(); ++channel)
+                texel[channel] = decoded[channel];
+        }
+    }
+
+    return output;
+}
+
+Color TiledImage::pagedColor(std::size_t index) const {
+    std::uint8_t texel[4] = {};
+    PagePool::shared().read(*file, firstPage + index / PageTexels, (index % PageTexels) * channels(), channels(), texel);
+    return color(texel);
+}
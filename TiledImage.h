@@ -0,0 +1,141 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_TILEDIMAGE_H
+#define RAYTRACER_TILEDIMAGE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "image.h"
+
+// Channels stored per texel: the color, or only the red channel for the maps read as a single value (specular maps)
+enum class TexelFormat { RGBA8, R8 };
+
+class TextureFile;
+
+/*
+ * Texture image in 8 bits per channel, as in the PNG files: 4 bytes a texel in RGBA8, 1 in R8, against the 32 bytes of
+ * a Color of doubles. A channel is converted to its value by a table of the 256 values. The alpha channel is not read
+ * by the renders, its byte is left to 0.
+ *
+ * The texels are stored in pages of 64 x 64 texels, the pages in scanline order. A page is made of tiles of one cache
+ * line, 4 x 4 texels in RGBA8 and 8 x 8 in R8: the texels around a lookup are in one or two lines whatever the
+ * direction in the image, where the scanline order has one line per row, and the lookups of the secondary rays,
+ * scattered over the image, read fewer lines.
+ *
+ * The pages are either in memory, or in the tiled cache file of a TextureFile, read on demand into the PagePool.
+ */
+class TiledImage {
+public:
+
+    // Side of a page in texels, and number of texels of a page
+    static constexpr int PageSide = 64;
+    static constexpr std::size_t PageTexels = PageSide * PageSide;
+
+    TiledImage() = default;
+    TiledImage(int width, int height, TexelFormat format);
+    TiledImage(const Image& image, TexelFormat format);
+    // The level of the texture in the cache file, its pages read through the PagePool
+    TiledImage(std::shared_ptr<const TextureFile> file, std::size_t level);
+
+    // Decodes a PNG file, without going through an Image of doubles. Throws std::runtime_error if it can not be read.
+    static TiledImage read_png(const std::string& fileName, TexelFormat format);
+
+    // Texel at normalized coordinates, the same one as BaseImage::colorAt. R8 texels are grey.
+    [[nodiscard]] Color colorAt(float x, float y) const { return colorOf(findex(x, y)); }
+    [[nodiscard]] Color operator()(int x, int y) const { return colorOf(index(x, y)); }
+
+    // Channels of the texel, 1 or 4 bytes, in the pages in memory
+    [[nodiscard]] const std::uint8_t* texel(int x, int y) const { return bytes() + index(x, y) * channels(); }
+    [[nodiscard]] std::uint8_t* texel(int x, int y) { return bytes() + index(x, y) * channels(); }
+
+    [[nodiscard]] int width() const { return _width; }
+    [[nodiscard]] int height() const { return _height; }
+    [[nodiscard]] TexelFormat format() const { return _format; }
+    [[nodiscard]] std::size_t channels() const { return channelsOf(_format); }
+    // Channels of the color, the alpha byte of RGBA8 being always 0
+    [[nodiscard]] std::size_t colorChannels() const { return _format == TexelFormat::RGBA8 ? 3 : 1; }
+
+    [[nodiscard]] std::size_t pageCount() const { return pagesPerRow * pageRows; }
+    [[nodiscard]] std::size_t pageBytes() const { return PageTexels * channels(); }
+    // Texels of the pages in memory, pageCount() * pageBytes() bytes
+    [[nodiscard]] const std::uint8_t* bytes() const { return reinterpret_cast<const std::uint8_t*>(tiles.data()); }
+
+    // Memory taken by the pages, 0 when they are in a cache file
+    [[nodiscard]] std::size_t memoryUsage() const { return tiles.size() * sizeof(Tile); }
+
+    static std::size_t channelsOf(TexelFormat format) { return format == TexelFormat::RGBA8 ? 4 : 1; }
+    // Pages covering an image, the last row and column of pages being padded
+    static std::size_t pageCountOf(int width, int height);
+
+private:
+
+    // Component of every channel byte, divided as by Image::read_png for the same values
+    static constexpr std::array<Scalar, 256> ChannelValues = [] {
+        std::array<Scalar, 256> output{};
+        for (std::size_t i = 0; i < output.size(); ++i)
+            output[i] = static_cast<Scalar>(i / 255.0);
+        return output;
+    }();
+
+    struct alignas(64) Tile {
+        std::uint8_t bytes[64];
+    };
+
+    static constexpr int PageShift = 6;
+
+    // Index of the texel in the pages, in texels
+    [[nodiscard]] std::size_t index(int x, int y) const {
+        auto page = static_cast<std::size_t>(y >> PageShift) * pagesPerRow + static_cast<std::size_t>(x >> PageShift);
+        int pageX = x & (PageSide - 1), pageY = y & (PageSide - 1);
+        int mask = (1 << tileShift) - 1;
+
+        // Rows of tiles, tiles of the row, then rows of texels of the tile
+        auto offset = ((pageY >> tileShift) << (PageShift + tileShift)) + ((pageX >> tileShift) << (2 * tileShift))
+                      + ((pageY & mask) << tileShift) + (pageX & mask);
+        return page * PageTexels + static_cast<std::size_t>(offset);
+    }
+
+    [[nodiscard]] std::size_t findex(float x, float y) const {
+        return index(int(wrapCoordinate(x) * (_width - 1)), int(wrapCoordinate(y) * (_height - 1)));
+    }
+
+    [[nodiscard]] Color colorOf(std::size_t index) const {
+        return file ? pagedColor(index) : color(bytes() + index * channels());
+    }
+
+    [[nodiscard]] std::uint8_t* bytes() { return reinterpret_cast<std::uint8_t*>(tiles.data()); }
+
+    [[nodiscard]] Color color(const std::uint8_t* texel) const {
+        // Read in a table rather than divided: a division of the components takes as long as the rest of the lookup
+        if (_format == TexelFormat::R8) {
+            Scalar grey = ChannelValues[texel[0]];
+            return Color::fromUnitComponents(grey, grey, grey);
+        }
+
+        return Color::fromUnitComponents(ChannelValues[texel[0]], ChannelValues[texel[1]], ChannelValues[texel[2]]);
+    }
+
+    [[nodiscard]] Color pagedColor(std::size_t index) const;
+
+    int _width = 0;
+    int _height = 0;
+    TexelFormat _format = TexelFormat::RGBA8;
+    // log2 of the side of a tile, in texels
+    int tileShift = 2;
+    std::size_t pagesPerRow = 0;
+    std::size_t pageRows = 0;
+    std::vector<Tile> tiles;
+
+    // Cache file of the pages, and first page of the image in the file
+    std::shared_ptr<const TextureFile> file;
+    std::size_t firstPage = 0;
+};
+
+
+#endif //RAYTRACER_TILEDIMAGE_H
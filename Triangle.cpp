@@ -4,9 +4,12 @@
 
 #include "Triangle.h"
 #include "light.h"
+#include "Statistics.h"
+#include <cmath>
 
 
 Hit Triangle::intersect(const Ray &ray) const {
+    COUNT_STATISTIC(TriangleTests);
 
     Hit planeHit = ownPlane.intersect(ray);
 
@@ -15,31 +18,48 @@ Hit Triangle::intersect(const Ray &ray) const {
 
     BarycentricCoordinates barycentricCoordinates = computeBarycentricCoordinates(planeHit.Position);
 
-
-    if (std::any_of(
-            barycentricCoordinates.begin(), barycentricCoordinates.end(),
-            [] (double d) { return d < 0 || d > 1; }))
+    if (! isInside(barycentricCoordinates))
         return Hit::NO_HIT();
 
-    if (barycentricCoordinates[0] + barycentricCoordinates[1] + barycentricCoordinates[2] > 1 + std::numeric_limits<double>::epsilon()) {
-        return Hit::NO_HIT();
-    }
-
     Vertex extrapolationOnHit = extrapolateFor(barycentricCoordinates, planeHit.Position);
 
-    return {
+    Hit output{
             (extrapolationOnHit.Position - ray.Origin).norm(),
             extrapolationOnHit.Position,
-            applyNormalMap(extrapolationOnHit.Position, extrapolationOnHit.Normal, normalUp),
-            ray
+            extrapolationOnHit.Normal,
+            ray,
+            0,
+            {barycentricCoordinates[1], barycentricCoordinates[2]}
     };
+    output.Normal = applyNormalMap(output, normalUp);
+
+    return output;
+}
+
+bool Triangle::occludes(const Ray &ray, double maxDistance) const {
+    COUNT_STATISTIC(TriangleTests);
+    double distance = ownPlane.getHitDistance(ray);
+
+    return distance < maxDistance && isInside(computeBarycentricCoordinates(ray.at(distance)));
 }
 
-std::array<double, 2> Triangle::getTextureCoordinatesFor(const Point &p) const {
+std::array<double, 2> Triangle::getTextureCoordinatesFor(const Hit &hit) const {
 
-    BarycentricCoordinates barycentricCoordinates = computeBarycentricCoordinates(p);
+    const std::array<double, 2>& local = hit.LocalCoordinates;
+    BarycentricCoordinates barycentricCoordinates{1 - local[0] - local[1], local[0], local[1]};
 
-    return extrapolateFor(barycentricCoordinates, p).UV;
+    return extrapolateFor(barycentricCoordinates, hit.Position).UV;
+}
+
+std::array<double, 2> Triangle::getTextureFootprint(const Hit&, double width) const {
+    // The texture coordinates being linear on the triangle, their area relatively to the one of the triangle gives
+    // their scale, the same along U and V
+    std::array<double, 2> uv1{Vertices[1].UV[0] - Vertices[0].UV[0], Vertices[1].UV[1] - Vertices[0].UV[1]};
+    std::array<double, 2> uv2{Vertices[2].UV[0] - Vertices[0].UV[0], Vertices[2].UV[1] - Vertices[0].UV[1]};
+    double uvArea = std::abs(uv1[0] * uv2[1] - uv1[1] * uv2[0]) / 2;
+
+    double extent = width * std::sqrt(uvArea * OneOverArea);
+    return {extent, extent};
 }
 
 Triangle::BarycentricCoordinates Triangle::computeBarycentricCoordinates(const Point &p) const {
@@ -53,6 +73,15 @@ Triangle::BarycentricCoordinates Triangle::computeBarycentricCoordinates(const P
     return output;
 }
 
+bool Triangle::isInside(const BarycentricCoordinates &barycentricCoordinates) {
+    if (std::any_of(
+            barycentricCoordinates.begin(), barycentricCoordinates.end(),
+            [] (double d) { return d < 0 || d > 1; }))
+        return false;
+
+    return barycentricCoordinates[0] + barycentricCoordinates[1] + barycentricCoordinates[2] <= 1 + std::numeric_limits<double>::epsilon();
+}
+
 double Triangle::computeArea() const {
     return computeAreaBetween(
             Vertices[0].Position,
@@ -85,3 +114,11 @@ Vector Triangle::computeNormalUp() const {
 
     return output.normalized();
 }
+
+std::optional<BoundingBox> Triangle::getBoundingBox() const {
+    BoundingBox output{};
+    for (const Vertex& vertex : Vertices)
+        output.extend(vertex.Position);
+
+    return output;
+}
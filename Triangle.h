@@ -36,7 +36,10 @@ public:
 
 
     [[nodiscard]] Hit intersect(const Ray &ray) const override;
-    [[nodiscard]] std::array<double, 2> getTextureCoordinatesFor(const Point &) const override;
+    [[nodiscard]] bool occludes(const Ray &ray, double maxDistance) const override;
+    [[nodiscard]] std::array<double, 2> getTextureCoordinatesFor(const Hit &) const override;
+    [[nodiscard]] std::array<double, 2> getTextureFootprint(const Hit &, double width) const override;
+    [[nodiscard]] std::optional<BoundingBox> getBoundingBox() const override;
 
 
 private:
@@ -44,6 +47,7 @@ private:
     typedef std::array<double, 3> BarycentricCoordinates;
 
     [[nodiscard]] BarycentricCoordinates computeBarycentricCoordinates(const Point &) const;
+    [[nodiscard]] static bool isInside(const BarycentricCoordinates&);
     [[nodiscard]] double computeArea() const;
     [[nodiscard]] Vector computeNormalUp() const;
     [[nodiscard]] Vertex extrapolateFor(const BarycentricCoordinates&, const Vector& position) const;
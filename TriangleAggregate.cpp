@@ -3,87 +3,80 @@
 //
 
 #include "TriangleAggregate.h"
+#include "Statistics.h"
+#include <chrono>
+#include <sstream>
+
+TriangleAggregate::TriangleAggregate(CompiledMesh compiled)
+        : Object(compiled.Geometry.bounds().center()), mesh(std::move(compiled.Geometry)), hierarchy(std::move(compiled.Hierarchy))
+{
+    std::ostringstream origin;
+    origin << (compiled.Cached ? "read from the mesh cache in " : "compiled from the OBJ file in ") << compiled.Milliseconds << " ms";
+    printSummary(origin.str());
+}
+
+void TriangleAggregate::buildHierarchy() {
+    Statistics::PhaseTimer timer{Statistics::Phase::HierarchyBuild};
+    auto start = std::chrono::steady_clock::now();
+
+    hierarchy = WideTriangleHierarchy(mesh);
+
+    std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - start;
+
+    std::ostringstream origin;
+    origin << "built in " << buildTime.count() << " ms";
+    printSummary(origin.str());
+}
 
-#define ENABLE_PLACEMENT false
-
-std::unordered_map<Point, const Triangle&> TriangleAggregate::parentOf{};
-
-Sphere TriangleAggregate::computeCircumscribedSphere() const {
-
-    // Not the most exact method, but quick enough with good enough results
-
-    double minX = triangles[0].Vertices[0].Position.X(),
-           maxX = triangles[0].Vertices[0].Position.X(),
-           minY = triangles[0].Vertices[0].Position.Y(),
-           maxY = triangles[0].Vertices[0].Position.Y(),
-           minZ = triangles[0].Vertices[0].Position.Z(),
-           maxZ = triangles[0].Vertices[0].Position.Z();
-
-    for (const Triangle& triangle : triangles) {
-        for (const Vertex& vertex : triangle.Vertices) {
-            if (vertex.Position.X() < minX)
-                minX = vertex.Position.X();
-            if (vertex.Position.X() > maxX)
-                maxX = vertex.Position.X();
-            if (vertex.Position.Y() < minY)
-                minY = vertex.Position.Y();
-            if (vertex.Position.Y() > maxY)
-                maxY = vertex.Position.Y();
-            if (vertex.Position.Z() < minZ)
-                minZ = vertex.Position.Z();
-            if (vertex.Position.Z() > maxZ)
-                maxZ = vertex.Position.Z();
-        }
-    }
-
-    Point center{(maxX + minX)/2, (maxY + minY)/2, (maxZ + minZ)/2};
-
-    double maxDistanceSquared = 0;
-    for (const Triangle& triangle : triangles) {
-        for (const Vertex& vertex : triangle.Vertices) {
-            double distanceSquared = (center - vertex.Position).norm2();
-
-            if (distanceSquared > maxDistanceSquared)
-                maxDistanceSquared = distanceSquared;
-        }
-    }
-
-    return Sphere{center, std::sqrt(maxDistanceSquared)};
+void TriangleAggregate::printSummary(const std::string& hierarchyOrigin) const {
+    // What the same mesh used to take as one Triangle object per face
+    std::size_t triangleObjectsSize = mesh.triangleCount() * sizeof(Triangle);
+
+    std::cout << "Triangle aggregate: " << mesh.triangleCount() << " triangles, " << mesh.vertexCount() << " vertices, "
+              << mesh.memoryUsage() / 1024 << " KiB of mesh data (" << triangleObjectsSize / 1024 << " KiB as Triangle objects), "
+              << WideTriangleHierarchy::Width << "-wide hierarchy of " << hierarchy.nodeCount() << " nodes (" << hierarchy.memoryUsage() / 1024 << " KiB) "
+              << hierarchyOrigin << std::endl;
 }
 
 Hit TriangleAggregate::intersect(const Ray &ray) const {
+    COUNT_STATISTIC(MeshTests);
 
-#if ENABLE_PLACEMENT
-    return circumscribedSphere.intersect(ray);
-#endif
+    std::uint32_t triangleHit = 0;
+    std::array<double, 2> barycentricHit{};
+    double closestDistance = Hit::NO_HIT().Distance;
 
-    if (circumscribedSphere.intersect(ray) == Hit::NO_HIT()) {
+    if (! hierarchy.intersect(mesh, ray, closestDistance, triangleHit, barycentricHit))
         return Hit::NO_HIT();
-    }
 
+    Hit output{
+            closestDistance,
+            ray.at(closestDistance),
+            mesh.interpolateNormal(triangleHit, barycentricHit),
+            ray,
+            triangleHit,
+            barycentricHit
+    };
+
+    if (material.normalMap)
+        output.Normal = applyNormalMap(output, mesh.normalUp(triangleHit));
 
-    int triangleHitIndex = -1;
-    Hit finalHit = Hit::NO_HIT();
+    return output;
+}
 
-    for (std::size_t i = 0; i < triangles.size(); ++i) {
-        Hit currentHit = triangles[i].intersect(ray);
+bool TriangleAggregate::occludes(const Ray &ray, double maxDistance) const {
+    COUNT_STATISTIC(MeshTests);
+    return hierarchy.occluded(ray, maxDistance);
+}
 
-        if (currentHit.Distance < finalHit.Distance) {
-            triangleHitIndex = i;
-            finalHit = currentHit;
-        }
-    }
+std::array<double, 2> TriangleAggregate::getTextureCoordinatesFor(const Hit &hit) const {
+    return mesh.interpolateUV(hit.PrimitiveIndex, hit.LocalCoordinates);
+}
 
-    if (finalHit != Hit::NO_HIT()) {
-        #pragma omp critical
-        TriangleAggregate::parentOf.insert(std::pair<Vector, const Triangle&>(finalHit.Position, triangles[triangleHitIndex]));
-        return finalHit;
-    }
-    else {
-        return Hit::NO_HIT();
-    }
+std::array<double, 2> TriangleAggregate::getTextureFootprint(const Hit& hit, double width) const {
+    double extent = width * mesh.textureScale(hit.PrimitiveIndex);
+    return {extent, extent};
 }
 
-std::array<double, 2> TriangleAggregate::getTextureCoordinatesFor(const Point &position) const {
-    return TriangleAggregate::parentOf.at(position).getTextureCoordinatesFor(position);
+std::optional<BoundingBox> TriangleAggregate::getBoundingBox() const {
+    return hierarchy.bounds();
 }
@@ -0,0 +1,333 @@
+//
+// Created on 17/10/2026.
+//
+
+#include "WideTriangleHierarchy.h"
+#include "Statistics.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+    constexpr float Infinity = std::numeric_limits<float>::infinity();
+
+    // Every node popped pushes at most Width children, one of them being visited next
+    constexpr std::size_t StackSize = BoundingVolumeHierarchy::MaxDepth * (WideTriangleHierarchy::Width - 1) + 1;
+
+    // The float bounds have to contain the double ones
+    float roundDown(double value) {
+        auto output = static_cast<float>(value);
+        return output > value ? std::nextafter(output, -Infinity) : output;
+    }
+
+    float roundUp(double value) {
+        auto output = static_cast<float>(value);
+        return output < value ? std::nextafter(output, Infinity) : output;
+    }
+}
+
+WideTriangleHierarchy::FloatRay::FloatRay(const Ray &ray)
+    : OriginX(static_cast<float>(ray.Origin.X())), OriginY(static_cast<float>(ray.Origin.Y())), OriginZ(static_cast<float>(ray.Origin.Z())),
+    DirectionX(static_cast<float>(ray.Direction.X())), DirectionY(static_cast<float>(ray.Direction.Y())), DirectionZ(static_cast<float>(ray.Direction.Z())),
+    InverseDirectionX(1 / DirectionX), InverseDirectionY(1 / DirectionY), InverseDirectionZ(1 / DirectionZ)
+{ }
+
+WideTriangleHierarchy::WideTriangleHierarchy(const Mesh &mesh) {
+    int triangleCount = static_cast<int>(mesh.triangleCount());
+    std::vector<BoundingBox> triangleBounds(triangleCount);
+
+    #pragma omp parallel for
+    for (int i = 0; i < triangleCount; ++i)
+        triangleBounds[i] = mesh.triangleBounds(i);
+
+    // Leaves of Width triangles fill exactly one block
+    BoundingVolumeHierarchy binary{triangleBounds, Width};
+    if (binary.empty())
+        return;
+
+    rootBounds = binary.bounds();
+    nodes.reserve(binary.nodeCount() / 2 + 1);
+    blocks.reserve(triangleCount / Width + 1);
+
+    if (binary.node(0).isLeaf()) {
+        Node root{};
+        root.MinX[0] = roundDown(rootBounds.Min.X());
+        root.MinY[0] = roundDown(rootBounds.Min.Y());
+        root.MinZ[0] = roundDown(rootBounds.Min.Z());
+        root.MaxX[0] = roundUp(rootBounds.Max.X());
+        root.MaxY[0] = roundUp(rootBounds.Max.Y());
+        root.MaxZ[0] = roundUp(rootBounds.Max.Z());
+        root.ChildCount = 1;
+        root.Children[0] = addBlocks(mesh, binary, binary.node(0));
+        root.BlockCounts[0] = static_cast<std::uint32_t>(blocks.size());
+        nodes.push_back(root);
+    }
+    else {
+        collapse(mesh, binary, 0);
+    }
+
+    nodes.shrink_to_fit();
+    blocks.shrink_to_fit();
+}
+
+std::uint32_t WideTriangleHierarchy::collapse(const Mesh &mesh, const BoundingVolumeHierarchy &binary, std::uint32_t binaryNode) {
+    Lanes<std::uint32_t> children{};
+    std::size_t childCount = 0;
+    children[childCount++] = binaryNode + 1;
+    children[childCount++] = binary.node(binaryNode).Offset;
+
+    // Replacing the largest inner child by its own children until the node is full
+    while (childCount < Width) {
+        std::size_t largest = Width;
+        double largestArea = -1;
+
+        for (std::size_t i = 0; i < childCount; ++i) {
+            const BoundingVolumeHierarchy::Node& child = binary.node(children[i]);
+            if (! child.isLeaf() && child.Bounds.surfaceArea() > largestArea) {
+                largest = i;
+                largestArea = child.Bounds.surfaceArea();
+            }
+        }
+
+        if (largest == Width)
+            break;
+
+        std::uint32_t opened = children[largest];
+        children[largest] = opened + 1;
+        children[childCount++] = binary.node(opened).Offset;
+    }
+
+    auto nodeIndex = static_cast<std::uint32_t>(nodes.size());
+    nodes.emplace_back();
+
+    Node node{};
+    node.ChildCount = static_cast<std::uint32_t>(childCount);
+
+    for (std::size_t i = 0; i < childCount; ++i) {
+        const BoundingVolumeHierarchy::Node& child = binary.node(children[i]);
+
+        node.MinX[i] = roundDown(child.Bounds.Min.X());
+        node.MinY[i] = roundDown(child.Bounds.Min.Y());
+        node.MinZ[i] = roundDown(child.Bounds.Min.Z());
+        node.MaxX[i] = roundUp(child.Bounds.Max.X());
+        node.MaxY[i] = roundUp(child.Bounds.Max.Y());
+        node.MaxZ[i] = roundUp(child.Bounds.Max.Z());
+
+        if (child.isLeaf()) {
+            node.Children[i] = addBlocks(mesh, binary, child);
+            node.BlockCounts[i] = static_cast<std::uint32_t>(blocks.size()) - node.Children[i];
+        }
+        else {
+            node.Children[i] = collapse(mesh, binary, children[i]);
+            node.BlockCounts[i] = 0;
+        }
+    }
+
+    nodes[nodeIndex] = node;
+    return nodeIndex;
+}
+
+std::uint32_t WideTriangleHierarchy::addBlocks(const Mesh &mesh, const BoundingVolumeHierarchy &binary, const BoundingVolumeHierarchy::Node &leaf) {
+    auto firstBlock = static_cast<std::uint32_t>(blocks.size());
+
+    for (std::uint32_t first = 0; first < leaf.Count; first += Width) {
+        // Lanes left to zero are degenerated triangles, never hit
+        TriangleBlock block{};
+
+        for (std::size_t i = 0; i < Width && first + i < leaf.Count; ++i) {
+            std::uint32_t triangle = binary.primitive(leaf.Offset + first + i);
+            Point vertex0 = mesh.position(mesh.vertexOf(triangle, 0));
+            Vector edge1 = mesh.position(mesh.vertexOf(triangle, 1)) - vertex0;
+            Vector edge2 = mesh.position(mesh.vertexOf(triangle, 2)) - vertex0;
+
+            block.Vertex0X[i] = static_cast<float>(vertex0.X());
+            block.Vertex0Y[i] = static_cast<float>(vertex0.Y());
+            block.Vertex0Z[i] = static_cast<float>(vertex0.Z());
+            block.Edge1X[i] = static_cast<float>(edge1.X());
+            block.Edge1Y[i] = static_cast<float>(edge1.Y());
+            block.Edge1Z[i] = static_cast<float>(edge1.Z());
+            block.Edge2X[i] = static_cast<float>(edge2.X());
+            block.Edge2Y[i] = static_cast<float>(edge2.Y());
+            block.Edge2Z[i] = static_cast<float>(edge2.Z());
+            block.Triangles[i] = triangle;
+        }
+
+        blocks.push_back(block);
+    }
+
+    return firstBlock;
+}
+
+void WideTriangleHierarchy::intersectChildren(const Node &node, const FloatRay &ray, float maxDistance, Lanes<float> &distances) {
+    // Same slab test as BoundingBox::intersect, on every child at once
+    #pragma omp simd
+    for (std::size_t i = 0; i < Width; ++i) {
+        float tNear = 0, tFar = maxDistance;
+
+        float t1 = (node.MinX[i] - ray.OriginX) * ray.InverseDirectionX;
+        float t2 = (node.MaxX[i] - ray.OriginX) * ray.InverseDirectionX;
+        tNear = std::max(tNear, std::min(t1, t2));
+        tFar = std::min(tFar, std::max(t1, t2));
+
+        t1 = (node.MinY[i] - ray.OriginY) * ray.InverseDirectionY;
+        t2 = (node.MaxY[i] - ray.OriginY) * ray.InverseDirectionY;
+        tNear = std::max(tNear, std::min(t1, t2));
+        tFar = std::min(tFar, std::max(t1, t2));
+
+        t1 = (node.MinZ[i] - ray.OriginZ) * ray.InverseDirectionZ;
+        t2 = (node.MaxZ[i] - ray.OriginZ) * ray.InverseDirectionZ;
+        tNear = std::max(tNear, std::min(t1, t2));
+        tFar = std::min(tFar, std::max(t1, t2));
+
+        distances[i] = (i < node.ChildCount && tNear <= tFar) ? tNear : Infinity;
+    }
+}
+
+void WideTriangleHierarchy::intersectBlock(const TriangleBlock &block, const FloatRay &ray, float maxDistance,
+                                           Lanes<float> &distances, Lanes<float> &u, Lanes<float> &v) {
+    ADD_STATISTIC(MeshTriangleTests, Width);
+    // Same Möller-Trumbore test as Mesh::intersectTriangle, on every triangle of the block at once
+    #pragma omp simd
+    for (std::size_t i = 0; i < Width; ++i) {
+        float pX = ray.DirectionY * block.Edge2Z[i] - ray.DirectionZ * block.Edge2Y[i];
+        float pY = ray.DirectionZ * block.Edge2X[i] - ray.DirectionX * block.Edge2Z[i];
+        float pZ = ray.DirectionX * block.Edge2Y[i] - ray.DirectionY * block.Edge2X[i];
+
+        float determinant = block.Edge1X[i] * pX + block.Edge1Y[i] * pY + block.Edge1Z[i] * pZ;
+        float inverseDeterminant = 1 / determinant;
+
+        float tX = ray.OriginX - block.Vertex0X[i];
+        float tY = ray.OriginY - block.Vertex0Y[i];
+        float tZ = ray.OriginZ - block.Vertex0Z[i];
+        float uI = (tX * pX + tY * pY + tZ * pZ) * inverseDeterminant;
+
+        float qX = tY * block.Edge1Z[i] - tZ * block.Edge1Y[i];
+        float qY = tZ * block.Edge1X[i] - tX * block.Edge1Z[i];
+        float qZ = tX * block.Edge1Y[i] - tY * block.Edge1X[i];
+        float vI = (ray.DirectionX * qX + ray.DirectionY * qY + ray.DirectionZ * qZ) * inverseDeterminant;
+
+        float t = (block.Edge2X[i] * qX + block.Edge2Y[i] * qY + block.Edge2Z[i] * qZ) * inverseDeterminant;
+
+        bool hit = determinant != 0 && uI >= 0 && uI <= 1 && vI >= 0 && uI + vI <= 1 && t > 0 && t < maxDistance;
+        distances[i] = hit ? t : Infinity;
+        u[i] = uI;
+        v[i] = vI;
+    }
+}
+
+bool WideTriangleHierarchy::intersect(const Mesh &mesh, const Ray &ray, double &maxDistance, std::uint32_t &triangle,
+                                      std::array<double, 2> &barycentric) const {
+
+    if (nodes.empty())
+        return false;
+
+    struct ToVisit {
+        float Distance;
+        std::uint32_t Index;
+        std::uint32_t BlockCount;
+    };
+
+    const FloatRay floatRay{ray};
+    float closestDistance = roundUp(maxDistance);
+    bool found = false;
+
+    std::array<ToVisit, StackSize> toVisit;
+    std::size_t toVisitCount = 0;
+    toVisit[toVisitCount++] = {0, 0, 0};
+
+    Lanes<float> distances, u, v;
+
+    while (toVisitCount > 0) {
+        ToVisit current = toVisit[--toVisitCount];
+
+        // A closer hit may have been found since the child was pushed
+        if (current.Distance >= closestDistance)
+            continue;
+
+        if (current.BlockCount > 0) {
+            for (std::uint32_t b = current.Index; b < current.Index + current.BlockCount; ++b) {
+                intersectBlock(blocks[b], floatRay, closestDistance, distances, u, v);
+
+                for (std::size_t i = 0; i < Width; ++i) {
+                    if (distances[i] >= closestDistance)
+                        continue;
+
+                    // A candidate of the float test, kept only if the double test hits it too
+                    double distance;
+                    std::array<double, 2> exactBarycentric{};
+                    if (mesh.intersectTriangle(blocks[b].Triangles[i], ray, maxDistance, distance, exactBarycentric)) {
+                        maxDistance = distance;
+                        closestDistance = roundUp(distance);
+                        triangle = blocks[b].Triangles[i];
+                        barycentric = exactBarycentric;
+                        found = true;
+                    }
+                }
+            }
+            continue;
+        }
+
+        const Node& node = nodes[current.Index];
+        intersectChildren(node, floatRay, closestDistance, distances);
+
+        // Pushing the children hit from the farthest to the closest, the closest being visited first
+        std::array<std::size_t, Width> order{};
+        std::size_t hitCount = 0;
+        for (std::size_t i = 0; i < Width; ++i) {
+            if (distances[i] == Infinity)
+                continue;
+
+            std::size_t position = hitCount++;
+            while (position > 0 && distances[order[position - 1]] < distances[i]) {
+                order[position] = order[position - 1];
+                --position;
+            }
+            order[position] = i;
+        }
+
+        for (std::size_t i = 0; i < hitCount; ++i)
+            toVisit[toVisitCount++] = {distances[order[i]], node.Children[order[i]], node.BlockCounts[order[i]]};
+    }
+
+    return found;
+}
+
+bool WideTriangleHierarchy::occluded(const Ray &ray, double maxDistance) const {
+
+    if (nodes.empty())
+        return false;
+
+    const FloatRay floatRay{ray};
+    const float distanceLimit = static_cast<float>(maxDistance);
+
+    std::array<std::pair<std::uint32_t, std::uint32_t>, StackSize> toVisit;
+    std::size_t toVisitCount = 0;
+    toVisit[toVisitCount++] = {0, 0};
+
+    Lanes<float> distances, u, v;
+
+    while (toVisitCount > 0) {
+        auto [index, blockCount] = toVisit[--toVisitCount];
+
+        if (blockCount > 0) {
+            for (std::uint32_t b = index; b < index + blockCount; ++b) {
+                intersectBlock(blocks[b], floatRay, distanceLimit, distances, u, v);
+
+                for (float distance : distances) {
+                    if (distance < distanceLimit)
+                        return true;
+                }
+            }
+            continue;
+        }
+
+        const Node& node = nodes[index];
+        intersectChildren(node, floatRay, distanceLimit, distances);
+
+        for (std::size_t i = 0; i < Width; ++i) {
+            if (distances[i] != Infinity)
+                toVisit[toVisitCount++] = {node.Children[i], node.BlockCounts[i]};
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,94 @@
+//
+// Created on 17/10/2026.
+//
+
+#ifndef RAYTRACER_WIDETRIANGLEHIERARCHY_H
+#define RAYTRACER_WIDETRIANGLEHIERARCHY_H
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "Mesh.h"
+#include "BoundingVolumeHierarchy.h"
+
+/*
+ * Bounding volume hierarchy over the triangles of a mesh, with Width children per node.
+ *
+ * It is made by collapsing a binary BoundingVolumeHierarchy: each node takes the Width largest subtrees below it.
+ * The child bounds of a node and the triangles of a leaf are stored as structures of float arrays, so that a single
+ * `#pragma omp simd` loop tests a ray against every child of a node, or against Width triangles of a leaf.
+ * This vectorizes single rays as well, incoherent secondary rays included.
+ */
+class WideTriangleHierarchy {
+public:
+
+    static constexpr std::size_t Width = 4;
+
+    template <typename T>
+    using Lanes = std::array<T, Width>;
+
+    struct Node {
+        Lanes<float> MinX, MinY, MinZ, MaxX, MaxY, MaxZ;
+        // Inner child: index of the node. Leaf child: index of its first triangle block.
+        Lanes<std::uint32_t> Children;
+        // Number of triangle blocks of a leaf child, 0 for an inner child
+        Lanes<std::uint32_t> BlockCounts;
+        std::uint32_t ChildCount;
+    };
+
+    // Width triangles of a leaf, the lanes past the end of the leaf being degenerated triangles never hit
+    struct TriangleBlock {
+        Lanes<float> Vertex0X, Vertex0Y, Vertex0Z;
+        Lanes<float> Edge1X, Edge1Y, Edge1Z;
+        Lanes<float> Edge2X, Edge2Y, Edge2Z;
+        Lanes<std::uint32_t> Triangles;
+    };
+
+    WideTriangleHierarchy() = default;
+    explicit WideTriangleHierarchy(const Mesh& mesh);
+
+    /*
+     * Closest triangle of the mesh the hierarchy was built from hit before maxDistance. On a hit, lowers maxDistance
+     * and gives the triangle with the barycentric coordinates of the hit relatively to its second and third vertices.
+     * The triangles are found in single precision, and every candidate is tested again by Mesh::intersectTriangle in
+     * double precision: a candidate it misses is skipped, and the distance and coordinates are the ones it computes.
+     */
+    bool intersect(const Mesh& mesh, const Ray& ray, double& maxDistance, std::uint32_t& triangle,
+                   std::array<double, 2>& barycentric) const;
+    // Whether any triangle is hit before maxDistance
+    [[nodiscard]] bool occluded(const Ray& ray, double maxDistance) const;
+
+    [[nodiscard]] std::size_t nodeCount() const { return nodes.size(); }
+    [[nodiscard]] std::size_t memoryUsage() const { return nodes.capacity() * sizeof(Node) + blocks.capacity() * sizeof(TriangleBlock); }
+    [[nodiscard]] BoundingBox bounds() const { return rootBounds; }
+
+private:
+
+    // Writes and reads the nodes and blocks as they are
+    friend class MeshCache;
+
+    // Ray converted once to the single precision of the kernels
+    struct FloatRay {
+        float OriginX, OriginY, OriginZ;
+        float DirectionX, DirectionY, DirectionZ;
+        float InverseDirectionX, InverseDirectionY, InverseDirectionZ;
+
+        explicit FloatRay(const Ray& ray);
+    };
+
+    std::uint32_t collapse(const Mesh& mesh, const BoundingVolumeHierarchy& binary, std::uint32_t binaryNode);
+    std::uint32_t addBlocks(const Mesh& mesh, const BoundingVolumeHierarchy& binary, const BoundingVolumeHierarchy::Node& leaf);
+
+    // Distances to the boxes of the children of the node, infinity for the children missed
+    static void intersectChildren(const Node& node, const FloatRay& ray, float maxDistance, Lanes<float>& distances);
+    // Distances to the triangles of the block, infinity for the triangles missed
+    static void intersectBlock(const TriangleBlock& block, const FloatRay& ray, float maxDistance,
+                               Lanes<float>& distances, Lanes<float>& u, Lanes<float>& v);
+
+    std::vector<Node> nodes;
+    std::vector<TriangleBlock> blocks;
+    BoundingBox rootBounds;
+};
+
+
+#endif //RAYTRACER_WIDETRIANGLEHIERARCHY_H
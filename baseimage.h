@@ -5,6 +5,16 @@
 #ifndef RAYTRACER_BASEIMAGE_H
 #define RAYTRACER_BASEIMAGE_H
 
+#include <cmath>
+#include <vector>
+
+// Normalized image coordinate brought in [0, 1] by whole periods, the values above 1 going in (0, 1]
+inline float wrapCoordinate(float x) {
+    if (x > 1) return x - (std::ceil(x) - 1);
+    if (x < 0) return x - std::floor(x);
+    return x;
+}
+
 template<typename ValueType>
 class BaseImage {
 protected:
@@ -68,10 +78,7 @@ protected:
 
     inline int findex(float x, float y) const       //float index
     {
-        while (x > 1) x -= 1; while (x < 0) x += 1;
-        while (y > 1) y -= 1; while (y < 0) y += 1;
-
-        return index(int(x * (_width-1)), int(y * (_height-1)));
+        return index(int(wrapCoordinate(x) * (_width-1)), int(wrapCoordinate(y) * (_height-1)));
     }
 
     // Create a picture. Return false if failed.
@@ -0,0 +1,374 @@
+//
+// Created on 17/10/2026.
+//
+// Micro-benchmarks of the kernels the renders depend on: intersections, scene queries, shading, texture lookups,
+// rotations, PNG encoding, and the reading of the OBJ and scene files. Every kernel runs on a fixed set of inputs
+// drawn from a seeded generator, so that the results (and their checksums) can be compared between two builds.
+//
+// The results are printed on the standard output as a JSON document.
+//
+
+#include <chrono>
+#include <fstream>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "scene.h"
+#include "sphere.h"
+#include "Cone.h"
+#include "Triangle.h"
+#include "box.h"
+#include "Plane.h"
+#include "Quaternion.h"
+#include "Texture.h"
+#include "TextureFile.h"
+#include "PagePool.h"
+#include "ObjModel.h"
+#include "glm.h"
+#include "raytracer.h"
+
+namespace {
+    constexpr std::size_t InputCount = 4096;
+    constexpr std::mt19937::result_type Seed = 20210130;
+
+    struct Result {
+        std::string Name;
+        std::size_t Operations;
+        double NanosecondsPerOperation;
+        // Whether an operation traces a ray, the throughput being then given in rays per second
+        bool TracesRays;
+        // Sum of the outputs of the first batch, identical between two runs on the same inputs
+        double Checksum;
+    };
+
+    /*
+     * Runs kernel(0) to kernel(batchSize - 1) until minimumTime is elapsed. The kernel returns a value depending on its
+     * output, summed in the checksum so that the computation can not be optimized away.
+     */
+    template <typename Kernel>
+    Result measure(const std::string& name, std::size_t batchSize, bool tracesRays,
+                   std::chrono::duration<double> minimumTime, Kernel&& kernel) {
+        double checksum = 0;
+        for (std::size_t i = 0; i < batchSize; ++i)
+            checksum += kernel(i);
+
+        volatile double sink = 0;
+        std::size_t operations = 0;
+        std::chrono::duration<double> elapsed{};
+        auto start = std::chrono::steady_clock::now();
+
+        do {
+            double sum = 0;
+            for (std::size_t i = 0; i < batchSize; ++i)
+                sum += kernel(i);
+
+            sink = sink + sum;
+            operations += batchSize;
+            elapsed = std::chrono::steady_clock::now() - start;
+        } while (elapsed < minimumTime);
+
+        return {name, operations, elapsed.count() * 1e9 / operations, tracesRays, checksum};
+    }
+
+    double distanceOf(const Hit& hit) {
+        return std::isfinite(hit.Distance) ? hit.Distance : 0;
+    }
+
+    // Rays from a sphere of radius 4 * size around the origin, aimed at points within 2 * size of it,
+    // so that a part of them misses an object of the given size centered on the origin
+    std::vector<Ray> makeRays(double size, std::mt19937& generator) {
+        std::uniform_real_distribution<double> coordinate{-1, 1};
+        auto randomPoint = [&generator, &coordinate] {
+            return Vector{coordinate(generator), coordinate(generator), coordinate(generator)};
+        };
+
+        std::vector<Ray> rays;
+        rays.reserve(InputCount);
+
+        while (rays.size() < InputCount) {
+            Vector origin = randomPoint();
+            if (origin.norm() < 1e-3)
+                continue;
+
+            origin = origin.normalized() * 4 * size;
+            rays.emplace_back(origin, randomPoint() * 2 * size - origin);
+        }
+
+        return rays;
+    }
+
+    /*
+     * Scene of objectCount objects cycling through the inline object types, each with its own material. Like the
+     * hand-written scenes, they leave most optional keys (quaternion, UV_scale, UV1, specularMap, index, type) out.
+     */
+    void writeGeneratedScene(const std::string& fileName, std::size_t objectCount, std::mt19937& generator) {
+        std::uniform_real_distribution<double> coordinate{0, 400}, component{0, 1};
+        auto vector = [&generator] (std::uniform_real_distribution<double>& distribution) {
+            return "[" + std::to_string(distribution(generator)) + ", " + std::to_string(distribution(generator))
+                   + ", " + std::to_string(distribution(generator)) + "]";
+        };
+
+        std::ofstream output{fileName};
+        output << "---\nEye: [200, 200, 1000]\nLights:\n- position: [-200, 600, 1500]\n  color: [1, 1, 1]\nObjects:\n";
+
+        for (std::size_t i = 0; i < objectCount; ++i) {
+            switch (i % 6) {
+                case 0:
+                    output << "- type: sphere\n  position: " << vector(coordinate) << "\n  radius: 5\n";
+                    break;
+                case 1:
+                    output << "- type: plane\n  position: " << vector(coordinate) << "\n  normal: [0, 1, 0]\n";
+                    break;
+                case 2:
+                    output << "- type: triangle\n  corner1: " << vector(coordinate) << "\n  corner2: "
+                           << vector(coordinate) << "\n  corner3: " << vector(coordinate) << "\n";
+                    break;
+                case 3:
+                    output << "- type: box\n  position: " << vector(coordinate)
+                           << "\n  up: [0, 10, 0]\n  side: [10, 0, 0]\n  depth: 10\n";
+                    break;
+                case 4:
+                    output << "- type: cone\n  position: " << vector(coordinate) << "\n  up: [0, 20, 0]\n  radius: 5\n";
+                    break;
+                default:
+                    output << "- type: quadrilateral\n  position: " << vector(coordinate)
+                           << "\n  up: [0, 10, 0]\n  side: [10, 0, 0]\n";
+                    break;
+            }
+
+            output << "  material:\n    color: " << vector(component)
+                   << "\n    ka: 0.2\n    kd: 0.7\n    ks: 0.5\n    n: 64\n";
+        }
+    }
+
+    void printJson(const std::vector<Result>& results, std::chrono::duration<double> minimumTime) {
+        std::cout << "{\n  \"min_time_ms\": " << minimumTime.count() * 1000 << ",\n  \"benchmarks\": [";
+
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& result = results[i];
+            std::cout << (i == 0 ? "\n" : ",\n")
+                      << "    {\"name\": \"" << result.Name << "\""
+                      << ", \"operations\": " << result.Operations
+                      << ", \"ns_per_op\": " << result.NanosecondsPerOperation
+                      << ", \"" << (result.TracesRays ? "rays_per_sec" : "ops_per_sec") << "\": " << 1e9 / result.NanosecondsPerOperation
+                      << ", \"checksum\": " << result.Checksum << "}";
+        }
+
+        std::cout << "\n  ]\n}" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::chrono::duration<double> minimumTime = std::chrono::milliseconds{200};
+    std::string filter;
+    // Where the OBJ models of the scenes are, from the build directory
+    std::filesystem::path modelDirectory = "..";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        bool valid = (argument == "--min-time" || argument == "--filter" || argument == "--models") && i + 1 < argc;
+        if (valid) {
+            std::string value = argv[++i];
+            if (argument == "--min-time") {
+                try {
+                    double milliseconds = std::stod(value);
+                    valid = std::isfinite(milliseconds) && milliseconds >= 0;
+                    minimumTime = std::chrono::duration<double, std::milli>{milliseconds};
+                } catch (const std::logic_error&) {
+                    valid = false;
+                }
+            }
+            else if (argument == "--models")
+                modelDirectory = value;
+            else
+                filter = value;
+        }
+
+        if (! valid) {
+            std::cerr << "Usage: " << argv[0] << " [--min-time ms] [--filter name-part] [--models directory]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::mt19937 generator{Seed};
+    std::vector<Result> results;
+
+    auto run = [&results, &filter, minimumTime] (const std::string& name, std::size_t batchSize, bool tracesRays, auto&& kernel) {
+        if (name.find(filter) == std::string::npos)
+            return;
+
+        results.push_back(measure(name, batchSize, tracesRays, minimumTime, kernel));
+        std::cerr << name << ": " << results.back().NanosecondsPerOperation << " ns/op" << std::endl;
+    };
+
+    auto runIntersect = [&run, &generator] (const std::string& name, const Object& object, double size) {
+        std::vector<Ray> rays = makeRays(size, generator);
+        run(name, rays.size(), true, [&object, &rays] (std::size_t i) { return distanceOf(object.intersect(rays[i])); });
+    };
+
+    runIntersect("Sphere::intersect", Sphere{Point{0, 0, 0}, 1}, 1);
+    runIntersect("Cone::intersect", Cone{Point{0, -1, 0}, Vector{1, 0, 0}, Vector{0, 2, 0}}, 1);
+    runIntersect("Triangle::intersect", Triangle{Point{-1, -1, 0}, Point{1, -1, 0}, Point{0, 1, 0}}, 1);
+    runIntersect("Quadrilateral::intersect", Quadrilateral{Point{-1, -1, 0}, Vector{0, 2, 0}, Vector{2, 0, 0}}, 1);
+    runIntersect("Plane::intersect", Plane{Point{0, 0, 0}, Vector{0, 1, 0}}, 1);
+
+    {
+        // 16 x 16 spheres and boxes over a ground plane
+        Scene scene;
+        for (int x = -8; x < 8; ++x) {
+            for (int z = -8; z < 8; ++z) {
+                if ((x + z) % 2 == 0)
+                    scene.addObject(std::make_unique<Sphere>(Point{x + 0.5, 0.5, z + 0.5}, 0.4));
+                else
+                    scene.addObject(std::make_unique<Box>(Point{x + 0.2, 0.2, z + 0.2}, Vector{0, 0.6, 0}, Vector{0.6, 0, 0}, 0.6));
+            }
+        }
+        scene.addObject(std::make_unique<Plane>(Point{0, 0, 0}, Vector{0, 1, 0}));
+        scene.buildObjectHierarchy();
+
+        std::vector<Ray> rays = makeRays(8, generator);
+        run("Scene::findClosestHit", rays.size(), true, [&scene, &rays] (std::size_t i) {
+            return distanceOf(scene.findClosestHit(rays[i]).second);
+        });
+    }
+
+    {
+        Sphere sphere{Point{0, 0, 0}, 1};
+        std::vector<Hit> hits;
+        for (const Ray& ray : makeRays(1, generator)) {
+            Hit hit = sphere.intersect(ray);
+            if (std::isfinite(hit.Distance))
+                hits.push_back(hit);
+        }
+
+        Light light{Point{-5, 5, 5}, Color{1, 1, 1}, 0};
+        Material material;
+        material.n = 32;
+
+        run("Light::computeSpecularPhongAt", hits.size(), false, [&light, &material, &hits] (std::size_t i) {
+            return light.computeSpecularPhongAt(hits[i], material, 1).Red();
+        });
+    }
+
+    {
+        Image texture{1024, 1024};
+        for (int y = 0; y < texture.height(); ++y) {
+            for (int x = 0; x < texture.width(); ++x)
+                texture(x, y) = Color{x / 1024.0, y / 1024.0, ((x ^ y) & 0xFF) / 255.0};
+        }
+
+        std::uniform_real_distribution<float> coordinate{0, 1};
+        std::vector<std::array<float, 2>> coordinates(InputCount);
+        for (std::array<float, 2>& uv : coordinates)
+            uv = {coordinate(generator), coordinate(generator)};
+
+        run("BaseImage::colorAt", coordinates.size(), false, [&texture, &coordinates] (std::size_t i) {
+            return texture.colorAt(coordinates[i][0], coordinates[i][1]).Blue();
+        });
+
+        // Same texels in 8 bits, 4 MiB instead of 32. The texels of the lookups stay in the cache for both images: the
+        // difference is the addressing of the tiles and the conversion of the bytes, not the memory saved.
+        Texture mipmapped{TiledImage{texture, TexelFormat::RGBA8}};
+        run("Texture::colorAt", coordinates.size(), false, [&mipmapped, &coordinates] (std::size_t i) {
+            return mipmapped.colorAt(coordinates[i][0], coordinates[i][1]).Blue();
+        });
+
+        // Footprint of 24 texels: two levels of 64 x 64 and 32 x 32 texels read
+        run("Texture::colorAt (minified)", coordinates.size(), false, [&mipmapped, &coordinates] (std::size_t i) {
+            return mipmapped.colorAt(coordinates[i][0], coordinates[i][1], {24 / 1024.0, 24 / 1024.0}).Blue();
+        });
+
+        // Same texels read from a tiled cache file, through the page pool: with the 4 MiB of the texture in the budget,
+        // then with a quarter of it
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "raytracer-benchmark-tiles";
+        std::string fileName = (directory / "texture.png").string();
+        std::filesystem::create_directories(directory);
+        texture.write_png(fileName.c_str());
+        {
+            Texture paged{TextureFile::open(fileName, TexelFormat::RGBA8, directory)};
+            for (std::size_t budget : {std::size_t{64} << 20, std::size_t{1} << 20}) {
+                PagePool::shared().setBudget(budget);
+                run("Texture::colorAt (paged, " + std::to_string(budget >> 20) + " MiB)", coordinates.size(), false,
+                    [&paged, &coordinates] (std::size_t i) {
+                        return paged.colorAt(coordinates[i][0], coordinates[i][1]).Blue();
+                    });
+            }
+            PagePool::shared().clear();
+        }
+        std::filesystem::remove_all(directory);
+    }
+
+    // The OBJ models of the scenes, read by glm and by ObjModel, the checksum being their number of triangles
+    for (const char* model : {"devilduk.obj", "dolphins.obj", "Medievil_Helmet_OBJ/Medievil_01.obj",
+                              "Medievil_Helmet_OBJ/Medievil_02.obj", "Medievil_Helmet_OBJ/Medievil_03.obj"}) {
+        std::string fileName = (modelDirectory / model).string();
+        if (! std::filesystem::exists(fileName))
+            continue;
+
+        std::string name = std::filesystem::path{model}.filename().string();
+        run("glmReadOBJ (" + name + ")", 1, false, [&fileName] (std::size_t) {
+            std::vector<char> path(fileName.begin(), fileName.end());
+            path.push_back('\0');
+            GLMmodel* objModel = glmReadOBJ(path.data());
+            double triangles = objModel->numtriangles;
+            glmDelete(objModel);
+            return triangles;
+        });
+        run("ObjModel::read (" + name + ")", 1, false, [&fileName] (std::size_t) {
+            return static_cast<double>(ObjModel::read(fileName).Triangles.size());
+        });
+    }
+
+    // Generated scenes of two sizes, the time per object being the same for a reading linear in the size of the file.
+    // The checksum is the number of objects read.
+    for (std::size_t objectCount : {std::size_t{10000}, std::size_t{100000}}) {
+        std::string fileName = (std::filesystem::temp_directory_path() / "raytracer-benchmark-scene.yaml").string();
+        writeGeneratedScene(fileName, objectCount, generator);
+
+        run("Raytracer::readYaml (" + std::to_string(objectCount) + " objects)", 1, false, [&fileName] (std::size_t) {
+            SceneDescription description;
+            Raytracer::readYaml(fileName, description);
+            return static_cast<double>(description.Objects.size());
+        });
+        std::remove(fileName.c_str());
+    }
+
+    {
+        std::uniform_real_distribution<double> coordinate{-1, 1};
+        std::vector<std::pair<Quaternion, Vector>> rotations(InputCount);
+        for (std::pair<Quaternion, Vector>& rotation : rotations) {
+            rotation.first = Quaternion{coordinate(generator), coordinate(generator), coordinate(generator), coordinate(generator)}.normalized();
+            rotation.second = Vector{coordinate(generator), coordinate(generator), coordinate(generator)};
+        }
+
+        run("Quaternion::applyRotation", rotations.size(), false, [&rotations] (std::size_t i) {
+            return rotations[i].first.applyRotation(rotations[i].second).X();
+        });
+    }
+
+    {
+        Image image{256, 256};
+        for (int y = 0; y < image.height(); ++y) {
+            for (int x = 0; x < image.width(); ++x)
+                image(x, y) = Color{x / 256.0, y / 256.0, ((x * y) & 0xFF) / 255.0};
+        }
+
+        std::string fileName = (std::filesystem::temp_directory_path() / "raytracer-benchmark.png").string();
+        run("Image::write_png", 1, false, [&image, &fileName] (std::size_t) {
+            image.write_png(fileName.c_str());
+            return 0.0;
+        });
+        std::remove(fileName.c_str());
+    }
+
+    printJson(results, minimumTime);
+
+    return 0;
+}
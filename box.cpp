@@ -3,26 +3,43 @@
 //
 
 #include "box.h"
-
-std::unordered_map<Point, const Quadrilateral&> Box::parentOf{};
+#include "Statistics.h"
+#include <algorithm>
 
 Hit Quadrilateral::intersect(const Ray &ray) const {
+    COUNT_STATISTIC(QuadrilateralTests);
 
     Hit planeHit = ownPlane.intersect(ray);
 
     if (planeHit == Hit::NO_HIT())
         return Hit::NO_HIT();
 
-    std::array<double, 2> UV = getTextureCoordinatesFor(planeHit.Position);
+    std::array<double, 2> UV = computeFaceCoordinates(planeHit.Position);
 
-    if (UV[0] < 0 || UV[0] > 1 || UV[1] < 0 || UV[1] > 1) {
+    if (! isInside(UV)) {
         return Hit::NO_HIT();
     }
 
-    return {(planeHit.Position - ray.Origin).norm(), planeHit.Position, planeHit.Normal, ray};
+    return {(planeHit.Position - ray.Origin).norm(), planeHit.Position, planeHit.Normal, ray, 0, UV};
+}
+
+bool Quadrilateral::occludes(const Ray &ray, double maxDistance) const {
+    COUNT_STATISTIC(QuadrilateralTests);
+    double distance = ownPlane.getHitDistance(ray);
+
+    return distance < maxDistance && isInside(computeFaceCoordinates(ray.at(distance)));
+}
+
+std::array<double, 2> Quadrilateral::getTextureCoordinatesFor(const Hit& hit) const {
+    return hit.LocalCoordinates;
 }
 
-std::array<double, 2> Quadrilateral::getTextureCoordinatesFor(const Point& p) const {
+std::array<double, 2> Quadrilateral::getTextureFootprint(const Hit&, double width) const {
+    // The texture spans Side and Up once
+    return {width / Side.norm(), width / Up.norm()};
+}
+
+std::array<double, 2> Quadrilateral::computeFaceCoordinates(const Point& p) const {
     Vector positionToPoint = p - Position;
 
     // source: https://math.stackexchange.com/questions/148199/equation-for-non-orthogonal-projection-of-a-point-onto-two-vectors-representing
@@ -37,32 +54,58 @@ std::array<double, 2> Quadrilateral::getTextureCoordinatesFor(const Point& p) co
     return {sideComponent , 1-upComponent};
 }
 
+bool Quadrilateral::isInside(const std::array<double, 2> &faceCoordinates) {
+    return faceCoordinates[0] >= 0 && faceCoordinates[0] <= 1 && faceCoordinates[1] >= 0 && faceCoordinates[1] <= 1;
+}
+
+std::optional<BoundingBox> Quadrilateral::getBoundingBox() const {
+    BoundingBox output{};
+    output.extend(Position);
+    output.extend(Position + Up);
+    output.extend(Position + Side);
+    output.extend(Position + Up + Side);
+
+    return output;
+}
+
 Hit Box::intersect(const Ray &ray) const {
+    COUNT_STATISTIC(BoxTests);
 
-    int triangleHitIndex = -1;
     Hit finalHit = Hit::NO_HIT();
 
     for (std::size_t i = 0; i < Faces.size(); ++i) {
         Hit currentHit = Faces[i].intersect(ray);
 
         if (currentHit.Distance < finalHit.Distance) {
-            triangleHitIndex = i;
             finalHit = currentHit;
+            finalHit.PrimitiveIndex = i;
         }
     }
 
-    if (finalHit != Hit::NO_HIT()) {
-        #pragma omp critical
-        Box::parentOf.insert(std::pair<Vector, const Quadrilateral&>(finalHit.Position, Faces[triangleHitIndex]));
-        return finalHit;
-    }
-    else {
-        return Hit::NO_HIT();
-    }
+    return finalHit;
+}
+
+bool Box::occludes(const Ray &ray, double maxDistance) const {
+    COUNT_STATISTIC(BoxTests);
+    return std::any_of(Faces.begin(), Faces.end(), [&ray, maxDistance] (const Quadrilateral& face) {
+        return face.occludes(ray, maxDistance);
+    });
 }
 
-std::array<double, 2> Box::getTextureCoordinatesFor(const Point& position) const {
-    return Box::parentOf.at(position).getTextureCoordinatesFor(position);
+std::array<double, 2> Box::getTextureCoordinatesFor(const Hit& hit) const {
+    return Faces[hit.PrimitiveIndex].getTextureCoordinatesFor(hit);
+}
+
+std::array<double, 2> Box::getTextureFootprint(const Hit& hit, double width) const {
+    return Faces[hit.PrimitiveIndex].getTextureFootprint(hit, width);
+}
+
+std::optional<BoundingBox> Box::getBoundingBox() const {
+    BoundingBox output{};
+    for (const Quadrilateral& face : Faces)
+        output.extend(face.getBoundingBox().value());
+
+    return output;
 }
 
 std::array<Quadrilateral, 6>
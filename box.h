@@ -5,7 +5,6 @@
 #ifndef QUAD_H_115209AE
 #define QUAD_H_115209AE
 
-#include <unordered_map>
 #include "object.h"
 #include "Plane.h"
 
@@ -17,13 +16,19 @@ public:
     { }
 
     [[nodiscard]] Hit intersect(const Ray &ray) const override;
-    [[nodiscard]] std::array<double, 2> getTextureCoordinatesFor(const Point &) const override;
+    [[nodiscard]] bool occludes(const Ray &ray, double maxDistance) const override;
+    [[nodiscard]] std::array<double, 2> getTextureCoordinatesFor(const Hit &) const override;
+    [[nodiscard]] std::array<double, 2> getTextureFootprint(const Hit &, double width) const override;
+    [[nodiscard]] std::optional<BoundingBox> getBoundingBox() const override;
 
     const Vector Up;
     const Vector Side;
 
 private:
 
+    [[nodiscard]] std::array<double, 2> computeFaceCoordinates(const Point &) const;
+    [[nodiscard]] static bool isInside(const std::array<double, 2>& faceCoordinates);
+
     const Plane ownPlane{Position, getThirdOrthogonalVector(Side, Up)};
 
     // Used in UV calculations
@@ -37,7 +42,10 @@ public:
     Object(Position), Faces(computeFaces(Position, Up, Side, Depth))  { }
 
     [[nodiscard]] Hit intersect(const Ray &ray) const override;
-    [[nodiscard]] std::array<double, 2> getTextureCoordinatesFor(const Point &) const override;
+    [[nodiscard]] bool occludes(const Ray &ray, double maxDistance) const override;
+    [[nodiscard]] std::array<double, 2> getTextureCoordinatesFor(const Hit &) const override;
+    [[nodiscard]] std::array<double, 2> getTextureFootprint(const Hit &, double width) const override;
+    [[nodiscard]] std::optional<BoundingBox> getBoundingBox() const override;
 
     const std::array<Quadrilateral, 6> Faces;
 
@@ -46,9 +54,6 @@ private:
                                                     const Vector &vector1,
                                                     const Vector &vector2,
                                                     float depth);
-
-
-    static std::unordered_map<Point, const Quadrilateral&> parentOf;
 };
 
 
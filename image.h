@@ -18,7 +18,9 @@
 #include "baseimage.h"
 
 #include <iostream>
+#include <cstdint>
 #include <cstring>
+#include <fstream>
 #include <vector>
 #include "triple.h"
 #include "lodepng.h"
@@ -99,5 +101,57 @@ public:
 };
 
 
+// Unclamped render, clamped only when written to a PNG file
+class RadianceImage : public BaseImage<Radiance>
+{
+public:
+    RadianceImage()
+        : BaseImage()
+    { }
+
+    RadianceImage(int width, int height)
+            : BaseImage(width, height)
+    { }
+
+    [[nodiscard]] Image clamped() const {
+        Image output{_width, _height};
+        for (int y = 0; y < _height; ++y) {
+            for (int x = 0; x < _width; ++x)
+                output(x, y) = (*this)(x, y).clamped();
+        }
+        return output;
+    }
+
+    void write_png(const char* filename) const {
+        clamped().write_png(filename);
+    }
+
+    // Portable float map: 32 bit floats in RGB order, without clamping nor encoding. Return false if failed.
+    bool write_pfm(const char* filename) const {
+        std::ofstream output{filename, std::ios::binary};
+        if (! output)
+            return false;
+
+        // A negative scale means little endian floats
+        std::uint16_t endianness = 1;
+        bool littleEndian = *reinterpret_cast<unsigned char*>(&endianness) == 1;
+        output << "PF\n" << _width << " " << _height << "\n" << (littleEndian ? "-1.0" : "1.0") << "\n";
+
+        // The rows go from the bottom to the top of the image
+        std::vector<float> row(static_cast<std::size_t>(_width) * 3);
+        for (int y = _height - 1; y >= 0; --y) {
+            for (int x = 0; x < _width; ++x) {
+                const Radiance& pixel = (*this)(x, y);
+                for (std::size_t channel = 0; channel < 3; ++channel)
+                    row[3 * x + channel] = static_cast<float>(pixel[channel]);
+            }
+            output.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size() * sizeof(float)));
+        }
+
+        return static_cast<bool>(output);
+    }
+};
+
+
 
 #endif /* end of include guard: IMAGE_H_IOLFQARK */
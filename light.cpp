@@ -16,46 +16,46 @@
 #include "scene.h"
 
 
-Color Light::computeDiffusePhongAt(const Hit& hit_point, const Material& material, const Color& colorOnHit) const {
+Radiance Light::computeDiffusePhongAt(const Hit& hit_point, const Material& material, const Color& colorOnHit) const {
 
     Vector ray_reflection = -rotateAround(hit_point.Source.Direction, hit_point.Normal, 180);
     ray_reflection.normalize();
     Vector lightIncidence = Position - hit_point.Position;
     lightIncidence.normalize();
     double diffuseFactor = hit_point.Normal.dot(lightIncidence);
-    Color diffuseColor{};
+    Radiance diffuseColor{};
     if (diffuseFactor <= 0) {
         diffuseColor.set(0,0,0);
     }else {
-        diffuseColor = color * colorOnHit * material.kd * diffuseFactor;
+        diffuseColor = Radiance{color} * colorOnHit * material.kd * diffuseFactor;
     }
 
     return diffuseColor;
 }
 
-Color Light::computeDiffuseGoochAt(const Hit& hit_point, const Material& material, const Color& colorOnHit, GoochIlluminationModel illuminationModel) const {
+Radiance Light::computeDiffuseGoochAt(const Hit& hit_point, const Material& material, const Color& colorOnHit, GoochIlluminationModel illuminationModel) const {
     // source: http://artis.imag.fr/~Cyril.Soler/DEA/NonPhotoRealisticRendering/Papers/p447-gooch.pdf
 
-    Color kCool = Color{0, 0, illuminationModel.b} + illuminationModel.alpha * material.kd * colorOnHit;
-    Color kWarm = Color{illuminationModel.y, illuminationModel.y, 0} + illuminationModel.beta * material.kd * colorOnHit;
+    Radiance kCool = Radiance(0, 0, illuminationModel.b) + illuminationModel.alpha * material.kd * Radiance{colorOnHit};
+    Radiance kWarm = Radiance(illuminationModel.y, illuminationModel.y, 0) + illuminationModel.beta * material.kd * Radiance{colorOnHit};
 
     Vector lightIncidence = Position - hit_point.Position;
     lightIncidence.normalize();
     double diffuseFactor = hit_point.Normal.dot(lightIncidence);
     diffuseFactor = (diffuseFactor + 1) / 2;
-    Color diffuseColor = (1 - diffuseFactor) * (kCool)
+    Radiance diffuseColor = (1 - diffuseFactor) * (kCool)
                          + diffuseFactor * kWarm;
 
     // Highlights
     Vector ray_reflection = -rotateAround(hit_point.Source.Direction, hit_point.Normal, 180);
-    float ER = std::clamp(lightIncidence.dot(ray_reflection.normalized()), 0.0, 1.0);
+    float ER = std::clamp<double>(lightIncidence.dot(ray_reflection.normalized()), 0.0, 1.0);
 
-    Color specular = color * std::pow(ER, material.n);
+    Radiance specular = Radiance{color} * std::pow(ER, material.n);
 
     return diffuseColor; // + specular;
 }
 
-Color Light::computeSpecularGoochAt(const Hit& hit_point, const Material& material, const Color& colorOnHit, double specularValueOnHit) const {
+Radiance Light::computeSpecularGoochAt(const Hit& hit_point, const Material& material, const Color& colorOnHit, double specularValueOnHit) const {
     Vector ray_reflection = -rotateAround(hit_point.Source.Direction, hit_point.Normal, 180);
     ray_reflection.normalize();
     Vector lightIncidence = Position - hit_point.Position;
@@ -65,12 +65,12 @@ Color Light::computeSpecularGoochAt(const Hit& hit_point, const Material& materi
     if (specularFactor < 0) {
         specularFactor = 0;
     }
-    Color specularColor = color * specularValueOnHit * pow(specularFactor,material.n);
+    Radiance specularColor = Radiance{color} * specularValueOnHit * pow(specularFactor,material.n);
 
     return specularColor;
 }
 
-Color Light::computeSpecularPhongAt(const Hit &hit_point, const Material &material, double specularValueOnHit) const {
+Radiance Light::computeSpecularPhongAt(const Hit &hit_point, const Material &material, double specularValueOnHit) const {
     Vector ray_reflection = -rotateAround(hit_point.Source.Direction, hit_point.Normal, 180);
     ray_reflection.normalize();
     Vector lightIncidence = Position - hit_point.Position;
@@ -80,7 +80,7 @@ Color Light::computeSpecularPhongAt(const Hit &hit_point, const Material &materi
     if (specularFactor < 0){
         specularFactor = 0;
     }
-    Color specularColor = color * specularValueOnHit * pow(specularFactor,material.n);
+    Radiance specularColor = Radiance{color} * specularValueOnHit * pow(specularFactor,material.n);
 
     return specularColor;
 
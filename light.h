@@ -21,11 +21,13 @@
 #include <iostream>
 #include <limits>
 #include <algorithm>
+#include <array>
 #include "material.h"
 #include "triple.h"
 #include "commongeometry.h"
 
 class Color;
+class Radiance;
 class Hit;
 struct Material;
 
@@ -37,13 +39,25 @@ class Ray
 public:
     Point Origin;
     Vector Direction;
+    // Cone around the ray covering its footprint, for the texture filtering: width at the origin, and growth of the
+    // width per unit of distance. Both are 0 for the rays that do not come from the camera.
+    double ConeWidth = 0;
+    double ConeSpread = 0;
 
     Ray(const Point &from, const Vector &dir)
             : Origin(from), Direction(dir.normalized())
     { }
 
+    Ray(const Point &from, const Vector &dir, double coneWidth, double coneSpread)
+            : Origin(from), Direction(dir.normalized()), ConeWidth(coneWidth), ConeSpread(coneSpread)
+    { }
+
     Point at(double t) const
     { return Origin + t * Direction; }
+
+    // Width of the cone at distance t
+    double footprintAt(double t) const
+    { return ConeWidth + ConeSpread * t; }
 };
 
 bool inline operator==(const Ray &r1, const Ray &r2) {
@@ -61,9 +75,15 @@ public:
     Point Position;
     Vector Normal;
     Ray Source;
-
-    Hit(double Distance, Point Position, Vector Normal, Ray Source)
-            : Distance(Distance), Position(Position), Normal(Normal.normalized()), Source(Source)
+    // Part of the object that was hit, for the objects made of several primitives (face of a box, triangle of an aggregate)
+    std::size_t PrimitiveIndex;
+    // Parameters of the hit on that primitive: barycentric coordinates on a triangle, UV on a quadrilateral
+    std::array<double, 2> LocalCoordinates;
+
+    Hit(double Distance, Point Position, Vector Normal, Ray Source,
+        std::size_t PrimitiveIndex = 0, std::array<double, 2> LocalCoordinates = {0, 0})
+            : Distance(Distance), Position(Position), Normal(Normal.normalized()), Source(Source),
+            PrimitiveIndex(PrimitiveIndex), LocalCoordinates(LocalCoordinates)
     { }
 
     static const Hit& NO_HIT() {
@@ -98,11 +118,11 @@ public:
     Light(Point Position, Color c, float size) : Position(Position), color(c), Size(size)
     { }
 
-    [[nodiscard]] virtual Color computeSpecularPhongAt(const Hit& hit_point, const Material& material, double specularValueOnHit) const;
+    [[nodiscard]] virtual Radiance computeSpecularPhongAt(const Hit& hit_point, const Material& material, double specularValueOnHit) const;
 
-    [[nodiscard]] virtual Color computeDiffusePhongAt(const Hit&, const Material&, const Color& colorOnHit) const;
-    [[nodiscard]] virtual Color computeDiffuseGoochAt(const Hit&, const Material&, const Color& colorOnHit, GoochIlluminationModel illuminationModel) const;
-    [[nodiscard]] virtual Color computeSpecularGoochAt(const Hit&, const Material&, const Color& colorOnHit, double specularValueOnHit) const;
+    [[nodiscard]] virtual Radiance computeDiffusePhongAt(const Hit&, const Material&, const Color& colorOnHit) const;
+    [[nodiscard]] virtual Radiance computeDiffuseGoochAt(const Hit&, const Material&, const Color& colorOnHit, GoochIlluminationModel illuminationModel) const;
+    [[nodiscard]] virtual Radiance computeSpecularGoochAt(const Hit&, const Material&, const Color& colorOnHit, double specularValueOnHit) const;
 
     Point Position;
     Color color;
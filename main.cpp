@@ -15,32 +15,172 @@
 //
 
 #include "raytracer.h"
+#include "CacheFile.h"
+#include "MeshCache.h"
+#include "PagePool.h"
+#include "Statistics.h"
+#include "TextureCache.h"
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " in-file [out-file.png|out-file.pfm] [--scalar] [--tile-size N] [--threads N] [--tile-times file.csv] [--stream] [--stats file.json]"
+              << " [--heatmap file.png] [--heatmap-metric time|rays|tests] [--texture-budget MiB] [--texture-cache directory]"
+              << " [--mesh-cache directory|off] [--compile-scene out-file.rtscene]" << std::endl;
+    std::cerr << "  in-file       YAML scene file, or compiled scene file" << std::endl;
+    std::cerr << "  out-file.pfm  write the unclamped radiance as 32 bit floats instead of a PNG" << std::endl;
+    std::cerr << "  --scalar      trace the primary rays one by one instead of by packets" << std::endl;
+    std::cerr << "  --tile-size   side in pixels of the tiles shared between the threads (default 32)" << std::endl;
+    std::cerr << "  --threads     number of rendering threads (default: one per hardware thread)" << std::endl;
+    std::cerr << "  --tile-times  write the time taken by every tile to a CSV file" << std::endl;
+    std::cerr << "  --stream      write the image while rendering it, by bands of tiles (uncompressed PNG)" << std::endl;
+    std::cerr << "  --stats       write the ray and intersection counts and the phase timings as JSON ('-' for stdout)" << std::endl;
+    std::cerr << "  --heatmap     write an image of the cost of every pixel (not with --stream)" << std::endl;
+    std::cerr << "  --heatmap-metric  cost shown by the heatmap: time (default), rays or intersection tests" << std::endl;
+    std::cerr << "  --texture-budget  read the textures from tiled cache files, keeping at most that many MiB of them in memory (default 256)" << std::endl;
+    std::cerr << "  --texture-cache   directory of the tiled cache files (default: raytracer-textures-<user id> in the temporary directory)" << std::endl;
+    std::cerr << "  --mesh-cache      directory of the compiled OBJ meshes (default: raytracer-meshes-<user id> in the temporary directory), off to parse them every time" << std::endl;
+    std::cerr << "  --compile-scene   write the YAML scene file as a compiled scene file, loaded without parsing the YAML, instead of rendering it" << std::endl;
+}
 
 int main(int argc, char *argv[])
 {
     std::cout << "Introduction to Computer Graphics - Raytracer" << std::endl << std::endl;
-    if (argc < 2 || argc > 3) {
-        std::cerr << "Usage: " << argv[0] << " in-file [out-file.png]" << std::endl;
+
+    RenderOptions options;
+    std::vector<std::string> files;
+    std::string statisticsFile;
+    std::string compiledSceneFile;
+    // Out of core textures, with either option
+    std::string textureCacheDirectory;
+    long textureBudget = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        if (argument == "--scalar") {
+            options.PacketTracing = false;
+        }
+        else if (argument == "--stream") {
+            options.StreamOutput = true;
+        }
+        else if (argument == "--tile-size" || argument == "--threads" || argument == "--tile-times" || argument == "--stats"
+                || argument == "--heatmap" || argument == "--heatmap-metric" || argument == "--texture-budget"
+                || argument == "--texture-cache" || argument == "--mesh-cache" || argument == "--compile-scene") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: missing value after " << argument << std::endl;
+                return 1;
+            }
+            std::string value = argv[++i];
+
+            try {
+                if (argument == "--tile-size")
+                    options.TileSize = std::stoi(value);
+                else if (argument == "--threads") {
+                    // Parsed signed, for a negative count not to wrap around
+                    int threadCount = std::stoi(value);
+                    if (threadCount < 1)
+                        throw std::out_of_range{argument};
+                    options.ThreadCount = static_cast<unsigned int>(threadCount);
+                }
+                else if (argument == "--tile-times")
+                    options.TileTimingsFile = value;
+                else if (argument == "--heatmap")
+                    options.HeatmapFile = value;
+                else if (argument == "--texture-budget") {
+                    textureBudget = std::stol(value);
+                    if (textureBudget < 0)
+                        throw std::out_of_range{argument};
+                }
+                else if (argument == "--texture-cache")
+                    textureCacheDirectory = value;
+                else if (argument == "--compile-scene")
+                    compiledSceneFile = value;
+                else if (argument == "--mesh-cache")
+                    MeshCache::shared().setDirectory(value == "off" ? std::filesystem::path{} : std::filesystem::path{value});
+                else if (argument == "--heatmap-metric") {
+                    std::map<std::string, CostMetric> metrics{
+                            {"time", CostMetric::Time}, {"rays", CostMetric::Rays}, {"tests", CostMetric::IntersectionTests}};
+                    options.HeatmapMetric = metrics.at(value);
+                }
+                else
+                    statisticsFile = value;
+            } catch (const std::logic_error&) {
+                std::cerr << "Error: invalid value " << value << " for " << argument << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if (argument.rfind("--", 0) == 0) {
+            std::cerr << "Error: unknown option " << argument << std::endl;
+            return 1;
+        }
+        else {
+            files.push_back(argument);
+        }
+    }
+
+    if (files.empty() || files.size() > 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // The scale of the heatmap is known only once every pixel is rendered: its costs would be held for the whole image
+    if (options.StreamOutput && ! options.HeatmapFile.empty()) {
+        std::cerr << "Error: --heatmap can not be used with --stream" << std::endl;
+        printUsage(argv[0]);
         return 1;
     }
 
+    if (textureBudget >= 0 || ! textureCacheDirectory.empty()) {
+        if (textureBudget >= 0)
+            PagePool::shared().setBudget(static_cast<std::size_t>(textureBudget) << 20);
+        if (textureCacheDirectory.empty())
+            textureCacheDirectory = userCacheDirectory("raytracer-textures").string();
+        TextureCache::shared().setCacheDirectory(textureCacheDirectory);
+    }
+
+    if (! compiledSceneFile.empty())
+        return Raytracer::compileScene(files[0], compiledSceneFile) ? 0 : 1;
+
     Raytracer raytracer;
 
-    if (!raytracer.readScene(argv[1])) {
-        std::cerr << "Error: reading scene from " << argv[1] << " failed - no output generated."<< std::endl;
+    if (!raytracer.readScene(files[0])) {
+        std::cerr << "Error: reading scene from " << files[0] << " failed - no output generated."<< std::endl;
         return 1;
     }
+    raytracer.setRenderOptions(options);
+
     std::string ofname;
-    if (argc>=3) {
-        ofname = argv[2];
+    if (files.size() >= 2) {
+        ofname = files[1];
     } else {
-        ofname = argv[1];
-        if (ofname.size()>=5 && ofname.substr(ofname.size()-5)==".yaml") {
-            ofname = ofname.substr(0,ofname.size()-5);
+        ofname = files[0];
+        for (const std::string extension : {".yaml", ".rtscene"}) {
+            if (ofname.size() >= extension.size() && ofname.substr(ofname.size() - extension.size()) == extension) {
+                ofname = ofname.substr(0, ofname.size() - extension.size());
+                break;
+            }
         }
         ofname += ".png";
     }
     raytracer.renderToFile(ofname);
 
+    if (statisticsFile == "-") {
+        Statistics::writeJson(std::cout);
+    }
+    else if (! statisticsFile.empty()) {
+        std::ofstream statisticsOutput{statisticsFile};
+        if (statisticsOutput)
+            Statistics::writeJson(statisticsOutput);
+        else
+            std::cerr << "Error: unable to write the statistics to " << statisticsFile << std::endl;
+    }
+
     return 0;
 }
@@ -21,13 +21,3 @@ std::size_t CustomLightHash::operator()(Light const &light) const noexcept {
                                 light.Size
                                 );
 }
-
-void operator>>(const YAML::Node &node, MaterialType &type) {
-    auto s = node.Read<std::string>();
-    std::map<std::string, MaterialType> map{
-        {"default", MaterialType::DEFAULT},
-        {"reflection", MaterialType::REFLECTION},
-        {"refraction", MaterialType::REFRACTION}
-    };
-    type = map[s];
-}
\ No newline at end of file
@@ -16,6 +16,7 @@
 #define MATERIAL_H_TWMNT2EJ
 
 #include <unordered_map>
+#include <memory>
 #include <iostream>
 #include <optional>
 #include <array>
@@ -23,6 +24,7 @@
 #include "triple.h"
 #include "yaml/node.h"
 #include "image.h"
+#include "Texture.h"
 
 class Light;
 
@@ -36,9 +38,10 @@ struct Material
 {
 
     Color color;
-    std::optional<Image> texture;
-    std::optional<Image> specularMap;
-    std::optional<Image> normalMap;
+    // Shared with the other materials using the same files, see TextureCache
+    std::shared_ptr<const Texture> texture;
+    std::shared_ptr<const Texture> specularMap;
+    std::shared_ptr<const Texture> normalMap;
 
 
     std::unordered_map<Light, BaseImage<std::optional<std::array<double, 3>>>, CustomLightHash> refractedLightMaps{};
@@ -56,8 +59,6 @@ struct Material
     { }
 };
 
-void operator>>(const YAML::Node &node, MaterialType &mode);
-
 
 #include "light.h"
 #endif /* end of include guard: MATERIAL_H_TWMNT2EJ */
@@ -3,32 +3,89 @@
 //
 
 #include "object.h"
+#include "light.h"
+#include "Statistics.h"
+#include <algorithm>
+#include <cmath>
 
-Color Object::getColorOnPosition(const Point& position) const {
-    if (material.texture.has_value()) {
-        std::array<double, 2> uv = getTextureCoordinatesFor(position);
-        return material.texture.value().colorAt(uv[0], uv[1]);
+Color Object::getColorOnHit(const Hit& hit) const {
+    if (material.texture) {
+        std::array<double, 2> uv = getTextureCoordinatesFor(hit);
+        COUNT_STATISTIC(TextureLookups);
+        return material.texture->colorAt(uv[0], uv[1], getConeFootprint(hit));
     }
     else {
         return material.color;
     }
 }
 
-double Object::getSpecularOnPosition(const Point& position) const {
-    if (material.specularMap.has_value()) {
-        std::array<double, 2> uv = getTextureCoordinatesFor(position);
-        return material.specularMap.value().colorAt(uv[0], uv[1]).Red(); // Reading the red channel here, doesn't matter
+double Object::getSpecularOnHit(const Hit& hit) const {
+    if (material.specularMap) {
+        std::array<double, 2> uv = getTextureCoordinatesFor(hit);
+        COUNT_STATISTIC(TextureLookups);
+        return material.specularMap->colorAt(uv[0], uv[1], getConeFootprint(hit)).Red(); // Reading the red channel here, doesn't matter
     }
     else {
         return material.ks;
     }
 }
 
-Vector Object::applyNormalMap(const Point& position, const Vector& normal, const Vector& up) const {
-    if (material.normalMap.has_value()) {
-        std::array<double, 2> uv = getTextureCoordinatesFor(position);
+std::array<double, 2> Object::getTextureFootprint(const Hit& hit, double width) const {
+    Vector tangent = getAnyOrthogonalVector(hit.Normal).normalized();
+    Vector bitangent = hit.Normal.cross(tangent).normalized();
+    std::array<double, 2> uv = getTextureCoordinatesFor(hit);
+
+    std::array<double, 2> output{0, 0};
+    for (const Vector& direction : {tangent, bitangent}) {
+        Hit neighbour = hit;
+        neighbour.Position = hit.Position + direction * width;
+        std::array<double, 2> neighbourUV = getTextureCoordinatesFor(neighbour);
+
+        for (std::size_t i = 0; i < 2; ++i) {
+            // The textures repeat with a period of 1: a step across a seam (the meridian of a sphere) is a small one
+            double step = neighbourUV[i] - uv[i];
+            output[i] = std::max(output[i], std::abs(step - std::round(step)));
+        }
+    }
+
+    return output;
+}
+
+std::array<double, 2> Object::getConeFootprint(const Hit& hit) const {
+    double width = hit.Source.footprintAt(hit.Distance);
+    if (width <= 0)
+        return {0, 0};
+
+    // The cone is stretched by 1 / cosine on the surface along one direction only: the isotropic filtering takes
+    // the width of a disc of the same area, so that the grazing hits are not blurred along both directions
+    double cosine = std::abs(hit.Normal.dot(hit.Source.Direction));
+    return getTextureFootprint(hit, width / std::sqrt(std::max(cosine, 0.01)));
+}
+
+RayPacket::Mask Object::intersectPacket(RayPacket &packet, RayPacket::Mask activeRays) const {
+    RayPacket::Mask closer = 0;
+
+    for (std::size_t i = 0; i < RayPacket::Size; ++i) {
+        if (! RayPacket::contains(activeRays, i))
+            continue;
+
+        Hit hit = intersect(packet.Rays[i]);
+        if (hit.Distance < packet.Hits[i].Distance) {
+            packet.Hits[i] = hit;
+            closer |= RayPacket::Mask{1} << i;
+        }
+    }
+
+    return closer;
+}
+
+Vector Object::applyNormalMap(const Hit& hit, const Vector& up) const {
+    if (material.normalMap) {
+        std::array<double, 2> uv = getTextureCoordinatesFor(hit);
+        const Vector& normal = hit.Normal;
         Vector left = getThirdOrthogonalVector(up, normal).normalized();
-        Vector normalComponents = Vector{material.normalMap.value().colorAt(uv[0], uv[1])};
+        COUNT_STATISTIC(TextureLookups);
+        Vector normalComponents = Vector{material.normalMap->colorAt(uv[0], uv[1], getConeFootprint(hit))};
         normalComponents = normalComponents * 2 - 1; // converting to vector to bypass overflow prevention
         return (
                 left.normalized() * normalComponents.X()
@@ -37,13 +94,13 @@ Vector Object::applyNormalMap(const Point& position, const Vector& normal, const
         ).normalized();
     }
     else {
-        return normal;
+        return hit.Normal;
     }
 }
 
-std::array<double, 3> Object::getAdditionalLightFactor(const Light &light, const Point &position) const {
+std::array<double, 3> Object::getAdditionalLightFactor(const Light &light, const Hit &hit) const {
     if (material.refractedLightMaps.find(light) != material.refractedLightMaps.end()) {
-        std::array<double, 2> uv = getTextureCoordinatesFor(position);
+        std::array<double, 2> uv = getTextureCoordinatesFor(hit);
 
         return material.refractedLightMaps.at(light).colorAt(uv[0], uv[1]).value();
     }
@@ -22,6 +22,8 @@
 #include <array>
 #include "Quaternion.h"
 #include "commongeometry.h"
+#include "BoundingBox.h"
+#include "RayPacket.h"
 
 class Hit;
 class Ray;
@@ -37,14 +39,29 @@ public:
     { }
 
     [[nodiscard]] virtual Hit intersect(const Ray &ray) const = 0;
-    [[nodiscard]] virtual std::array<double, 2> getTextureCoordinatesFor(const Point &) const = 0;
+    // Whether the ray hits the object before maxDistance, without computing the hit itself (shadow rays)
+    [[nodiscard]] virtual bool occludes(const Ray &ray, double maxDistance) const = 0;
+    // Packet version of intersect: replaces the hits of the active rays the object is closer than, and returns
+    // the mask of those rays. Intersects the rays one by one unless overridden with a packet kernel.
+    virtual RayPacket::Mask intersectPacket(RayPacket &packet, RayPacket::Mask activeRays) const;
+    [[nodiscard]] virtual std::array<double, 2> getTextureCoordinatesFor(const Hit &) const = 0;
+    // Extent along U and V of a disc of the given width on the surface around the hit, from the texture coordinates
+    // at width from the hit by default
+    [[nodiscard]] virtual std::array<double, 2> getTextureFootprint(const Hit &, double width) const;
+    // Unbounded objects (planes) have no bounding box
+    [[nodiscard]] virtual std::optional<BoundingBox> getBoundingBox() const = 0;
 
-    [[nodiscard]] Color getColorOnPosition(const Point& position) const;
-    [[nodiscard]] double getSpecularOnPosition(const Point& position) const;
-    [[nodiscard]] Vector applyNormalMap(const Point& position, const Vector& normal, const Vector& up) const;
-    [[nodiscard]] std::array<double, 3> getAdditionalLightFactor(const Light&, const Point& position) const;
+    [[nodiscard]] Color getColorOnHit(const Hit& hit) const;
+    [[nodiscard]] double getSpecularOnHit(const Hit& hit) const;
+    // Normal of the hit perturbed by the normal map, up being the direction of the map's green channel
+    [[nodiscard]] Vector applyNormalMap(const Hit& hit, const Vector& up) const;
+    [[nodiscard]] std::array<double, 3> getAdditionalLightFactor(const Light&, const Hit& hit) const;
 
     virtual ~Object() = default;
+
+private:
+    // Footprint in texture coordinates of the ray cone of the hit, 0 without cone
+    [[nodiscard]] std::array<double, 2> getConeFootprint(const Hit& hit) const;
 };
 
 #endif /* end of include guard: OBJECT_H_AXKLE0OF */
@@ -17,39 +17,72 @@
 #include "Cone.h"
 #include "TriangleAggregate.h"
 #include "box.h"
+#include "PngStreamWriter.h"
+#include "Statistics.h"
+#include "PagePool.h"
+#include "TextureCache.h"
+#include "SceneAssets.h"
 #include <fstream>
 
+/*
+ * The tryRead functions give the default value to the variable, and return false, when the node is missing or can
+ * not be converted. Missing keys being the normal case, they are looked up with Node::FindValue and converted with
+ * Node::Read, neither throwing an exception.
+ */
 template <typename VariableType>
 bool tryRead(const YAML::Node &node, VariableType &variable, const VariableType& defaultValue = VariableType{}) {
-    try{
-        node >> variable;
+    if (node.Read(variable))
         return true;
-    } catch(YAML::Exception &e) {
-        variable = defaultValue;
-    }
 
+    variable = defaultValue;
     return false;
 }
 
 template <typename VariableType>
 bool tryRead(const YAML::Node &node, const std::string& key, VariableType &variable, const VariableType& defaultValue = VariableType{});
 
+// Scalars of a sequence of exactly Count elements
+template <typename ScalarType, std::size_t Count>
+bool readSequence(const YAML::Node &node, std::array<ScalarType, Count>& values) {
+    if (node.GetType() != YAML::CT_SEQUENCE || node.size() != Count)
+        return false;
+
+    std::size_t i = 0;
+    for (YAML::Iterator it = node.begin(), end = node.end(); it != end; ++it) {
+        if (! it->Read(values[i++]))
+            return false;
+    }
+
+    return true;
+}
 
 template <>
 bool tryRead<Mode>(const YAML::Node &node, Mode &variable, const Mode& defaultValue) {
-    try {
-        auto modeString = node.Read<std::string>();
+    static const std::map<std::string, Mode> modes{{"ZBUFFER", Mode::ZBUFFER}, {"PHONG", Mode::PHONG}, {"GOOCH", Mode::GOOCH}, {"NORMAL", Mode::NORMAL}, {"TEXTURE", Mode::TEXTURE}};
 
-        std::map<std::string, Mode> map{{"ZBUFFER", Mode::ZBUFFER}, {"PHONG", Mode::PHONG}, {"GOOCH", Mode::GOOCH}, {"NORMAL", Mode::NORMAL}, {"TEXTURE", Mode::TEXTURE}};
-        if (map.find(modeString) != map.end())
-            variable = map[modeString];
-        else
-            variable = defaultValue;
-    }
-    catch(YAML::Exception& e) {
+    std::string modeString;
+    auto mode = node.GetScalar(modeString) ? modes.find(modeString) : modes.end();
+    variable = mode != modes.end() ? mode->second : defaultValue;
+
+    return true;
+}
+
+template <>
+bool tryRead<MaterialType>(const YAML::Node &node, MaterialType &variable, const MaterialType& defaultValue) {
+    static const std::map<std::string, MaterialType> types{
+        {"default", MaterialType::DEFAULT},
+        {"reflection", MaterialType::REFLECTION},
+        {"refraction", MaterialType::REFRACTION}
+    };
+
+    std::string typeString;
+    auto type = node.GetScalar(typeString) ? types.find(typeString) : types.end();
+    if (type == types.end()) {
         variable = defaultValue;
+        return false;
     }
 
+    variable = type->second;
     return true;
 }
 
@@ -70,121 +103,67 @@ bool tryRead<RefractedShadowsParameters>(const YAML::Node &node, RefractedShadow
 
 template <>
 bool tryRead<Vector>(const YAML::Node &node, Vector &variable, const Vector& defaultValue) {
-
-    if (node.size() != 3) {
-        variable = defaultValue;
-        return false;
-    }
-
-    try {
-        node[0] >> variable.X();
-        node[1] >> variable.Y();
-        node[2] >> variable.Z();
-    }
-    catch (YAML::Exception & e) {
+    std::array<Scalar, 3> coordinates;
+    if (! readSequence(node, coordinates)) {
         variable = defaultValue;
         return false;
     }
 
+    variable = Vector(coordinates[0], coordinates[1], coordinates[2]);
     return true;
 }
 
 template <>
 bool tryRead<Color>(const YAML::Node &node, Color &variable, const Color& defaultValue) {
-
-    if (node.size() != 3) {
-        variable = defaultValue;
-        return false;
-    }
-
-    try {
-        node[0] >> variable.Red();
-        node[1] >> variable.Green();
-        node[2] >> variable.Blue();
-    }
-    catch (YAML::Exception & e) {
+    std::array<Scalar, 3> components;
+    if (! readSequence(node, components)) {
         variable = defaultValue;
         return false;
     }
 
+    variable.set(components[0], components[1], components[2]);
     return true;
 }
 
 template <>
 bool tryRead<std::array<unsigned int, 2>>(const YAML::Node &node, std::array<unsigned int, 2>& variable, std::array<unsigned int, 2>const& defaultValue) {
-
-    bool everythingOK = node.size() != 2;
-
-    if (everythingOK) {
-        try {
-            for (std::size_t i = 0; i < 2; ++i)
-                node[i] >> variable[i];
-        }
-        catch (YAML::Exception &e) {
-            everythingOK = false;
-        }
-    }
-
-    if (! everythingOK) {
+    if (! readSequence(node, variable)) {
         variable = defaultValue;
+        return false;
     }
 
-    return everythingOK;
+    return true;
 }
 
 template <>
-bool tryRead<Camera>(const YAML::Node &node, Camera& variable, const Camera& defaultValue) {
+bool tryRead<CameraDescription>(const YAML::Node &node, CameraDescription& variable, const CameraDescription& defaultValue) {
 
-    Point eye{}, center{};
-    Vector up{};
-    std::array<unsigned int, 2> ViewSize{};
+    bool everythingOK = tryRead(node, "eye", variable.Eye);
 
-    bool everythingOK = tryRead(node, "eye", eye);
-
-    tryRead(node, "center", center, {200,200,-200});
-    tryRead(node, "up", up, Vector{0, 1, 0});
-    tryRead(node, "viewSize", ViewSize, {400, 400});
+    tryRead(node, "center", variable.Center, {200,200,-200});
+    tryRead(node, "up", variable.Up, Vector{0, 1, 0});
+    tryRead(node, "viewSize", variable.ViewSize, {400, 400});
 
     if (! everythingOK) {
         variable = defaultValue;
     }
-    else {
-        variable = Camera{eye, center, up};
-        variable.ViewSize = ViewSize;
-    }
 
     return everythingOK;
 }
 
 template <>
-bool tryRead<Material>(const YAML::Node &node, Material &variable, const Material& defaultValue) {
+bool tryRead<MaterialDescription>(const YAML::Node &node, MaterialDescription &variable, const MaterialDescription& defaultValue) {
     bool everythingOK = true;
 
-    std::string texture;
-    std::string specularMap;
-    std::string normalMap;
-    if (tryRead(node, "texture", texture)) {
-        variable.texture = Image(texture.c_str());
-        if (variable.texture.value().size() == 0)
-            throw std::runtime_error("File not found: " + texture);
-    }
-    else {
+    if (! tryRead(node, "texture", variable.texture)) {
         everythingOK = tryRead(node, "color", variable.color, defaultValue.color);
     }
 
-    if (tryRead(node, "specularMap", specularMap)) {
-        variable.specularMap = Image(specularMap.c_str());
-        if (variable.specularMap.value().size() == 0)
-            throw std::runtime_error("File not found: " + texture);
-    }
-    else {
+    if (! tryRead(node, "specularMap", variable.specularMap)) {
         everythingOK = everythingOK && tryRead(node, "ks", variable.ks, defaultValue.ks);
     }
 
-    if (tryRead(node, "normalMap", normalMap)) {
-        variable.normalMap = Image(normalMap.c_str());
-
-    }
+    tryRead(node, "normalMap", variable.normalMap);
 
 
     everythingOK = everythingOK
@@ -202,115 +181,75 @@ bool tryRead<Material>(const YAML::Node &node, Material &variable, const Materia
 }
 
 template <>
-bool tryRead<std::unique_ptr<Object>>(const YAML::Node &node, std::unique_ptr<Object>& variable, const std::unique_ptr<Object>& defaultValueUnused) {
+bool tryRead<ObjectDescription>(const YAML::Node &node, ObjectDescription& variable, const ObjectDescription& /* defaultValueUnused */) {
     std::string objectType;
     tryRead(node, "type", objectType);
     bool everythingOK = false;
 
+    auto& [first, second, third] = variable.Vectors;
+    std::array<double, 6>& numbers = variable.Numbers;
+
     if (objectType == "sphere") {
-        Point pos{};
-        double r;
         Quaternion quaternion;
 
-        everythingOK = tryRead(node, "position", pos)
-            && tryRead(node, "radius", r);
+        variable.Type = ObjectType::Sphere;
+        everythingOK = tryRead(node, "position", first)
+            && tryRead(node, "radius", numbers[0]);
 
         tryRead(node, "quaternion", quaternion, Quaternion(0,0,0,1));
-
-        if (everythingOK)
-            variable = std::make_unique<Sphere>(pos, r, quaternion);
+        numbers[1] = quaternion.x;
+        numbers[2] = quaternion.y;
+        numbers[3] = quaternion.z;
+        numbers[4] = quaternion.w;
     }
     else if (objectType == "cone") {
-        Point pos{};
-        Vector side{};
         double radius;
-        Vector up{};
 
-        everythingOK = tryRead(node, "position", pos)
-            && tryRead(node, "up", up);
+        variable.Type = ObjectType::Cone;
+        everythingOK = tryRead(node, "position", first)
+            && tryRead(node, "up", third);
 
-        if (everythingOK && ! tryRead(node, "side", side))
+        if (everythingOK && ! tryRead(node, "side", second))
             if (tryRead(node, "radius", radius))
-                side = getAnyOrthogonalVector(up).normalized() * radius;
-
-        if (everythingOK)
-            variable = std::make_unique<Cone>(pos, side, up);
+                second = getAnyOrthogonalVector(third).normalized() * radius;
     }
     else if (objectType == "plane") {
-        Point pos{};
-        Vector norm{};
-        double scale;
+        variable.Type = ObjectType::Plane;
+        everythingOK = tryRead(node, "position", first)
+            && tryRead(node, "normal", second);
 
-        everythingOK = tryRead(node, "position", pos)
-            && tryRead(node, "normal", norm);
-
-        tryRead(node, "UV_scale", scale, 0.01);
-
-        if (everythingOK)
-            variable = std::make_unique<Plane>(pos, norm, scale);
+        tryRead(node, "UV_scale", numbers[0], 0.01);
     }
     else if (objectType == "triangle") {
-        Point p1{}, p2{}, p3{};
         std::array<double, 2> UV1{}, UV2{}, UV3{};
 
-        everythingOK = tryRead(node, "corner1", p1)
-                && tryRead(node, "corner2", p2)
-                && tryRead(node, "corner3", p3);
+        variable.Type = ObjectType::Triangle;
+        everythingOK = tryRead(node, "corner1", first)
+                && tryRead(node, "corner2", second)
+                && tryRead(node, "corner3", third);
 
 
         tryRead(node, "UV1", UV1, {0, 0});
         tryRead(node, "UV2", UV2, {1, 0});
         tryRead(node, "UV3", UV3, {0, 1});
-
-        Vector normal = getThirdOrthogonalVector(p2 - p1, p3 - p1);
-
-
-        if (everythingOK)
-            variable = std::make_unique<Triangle>(
-                    Vertex{p1, normal, UV1},
-                    Vertex{p2, normal, UV2},
-                    Vertex{p3, normal, UV3}
-                    );
+        numbers = {UV1[0], UV1[1], UV2[0], UV2[1], UV3[0], UV3[1]};
     }
     else if (objectType == "triangleAggregate") {
-
-        std::string fileName;
-
-        everythingOK = tryRead(node, "fileName", fileName);
-        if (everythingOK)
-            variable = std::make_unique<TriangleAggregate>(fileName);
+        variable.Type = ObjectType::TriangleAggregate;
+        everythingOK = tryRead(node, "fileName", variable.FileName);
     }
     else if (objectType == "quadrilateral") {
-
-        Point position{};
-        Vector up{}, side{};
-
-        everythingOK = tryRead(node, "position", position)
-                       && tryRead(node, "up", up)
-                       && tryRead(node, "side", side);
-
-        if (everythingOK)
-            variable = std::make_unique<Quadrilateral>(position, up, side);
+        variable.Type = ObjectType::Quadrilateral;
+        everythingOK = tryRead(node, "position", first)
+                       && tryRead(node, "up", second)
+                       && tryRead(node, "side", third);
     }
     else if (objectType == "box") {
-
-        Point position{};
-        Vector up{}, side{};
-        double depth;
-
-        everythingOK = tryRead(node, "position", position)
-                       && tryRead(node, "up", up)
-                       && tryRead(node, "side", side)
-                       && tryRead(node, "depth", depth);
-
-        if (everythingOK)
-            variable = std::make_unique<Box>(position, up, side, depth);
-    }
-
-
-    if (variable && everythingOK) {
-        // read the material and attach to object
-        everythingOK = tryRead(node, "material", variable->material);
+        variable.Type = ObjectType::Box;
+        everythingOK = tryRead(node, "position", first)
+                       && tryRead(node, "up", second)
+                       && tryRead(node, "side", third)
+                       && tryRead(node, "depth", numbers[0]);
     }
 
     return everythingOK;
@@ -318,16 +257,7 @@ bool tryRead<std::unique_ptr<Object>>(const YAML::Node &node, std::unique_ptr<Ob
 
 template<>
 bool tryRead<std::array<double, 2>>(const YAML::Node &node, std::array<double, 2>& variable, const std::array<double, 2>& defaultValue){
-    if (node.size() != 2) {
-        variable = defaultValue;
-        return false;
-    }
-
-    try {
-        node[0] >> variable[0];
-        node[1] >> variable[1];
-    }
-    catch (YAML::Exception & e) {
+    if (! readSequence(node, variable)) {
         variable = defaultValue;
         return false;
     }
@@ -337,39 +267,24 @@ bool tryRead<std::array<double, 2>>(const YAML::Node &node, std::array<double, 2
 
 template<>
 bool tryRead<Quaternion>(const YAML::Node &node, Quaternion& variable, const Quaternion& defaultValue){
-    if (node.size() != 4) {
-        variable = defaultValue;
-        return false;
-    }
-
-    try {
-        node[0] >> variable.x;
-        node[1] >> variable.y;
-        node[2] >> variable.z;
-        node[3] >> variable.w;
-    }
-    catch (YAML::Exception & e) {
+    std::array<double, 4> components;
+    if (! readSequence(node, components)) {
         variable = defaultValue;
         return false;
     }
 
+    variable = Quaternion(components[0], components[1], components[2], components[3]);
     return true;
 }
+
 template <>
-bool tryRead<std::unique_ptr<Light>>(const YAML::Node &node, std::unique_ptr<Light>& variable, const std::unique_ptr<Light>& defaultValueUnused)
+bool tryRead<LightDescription>(const YAML::Node &node, LightDescription& variable, const LightDescription& /* defaultValueUnused */)
 {
     bool everythingOK;
 
-    Point position;
-    Color color{};
-    float size;
-
-    everythingOK = tryRead(node, "position", position);
-    tryRead(node, "color", color, Color{1, 1, 1});
-    tryRead(node, "size", size, 200.f);
-
-    if (everythingOK)
-        variable = std::make_unique<Light>(position, color, size);
+    everythingOK = tryRead(node, "position", variable.Position);
+    tryRead(node, "color", variable.color, Color{1, 1, 1});
+    tryRead(node, "size", variable.Size, 200.f);
 
     return everythingOK;
 }
@@ -388,14 +303,78 @@ bool tryRead<GoochIlluminationModel>(const YAML::Node &node, GoochIlluminationMo
 template <typename VariableType>
 bool tryRead(const YAML::Node &node, const std::string& key, VariableType &variable, const VariableType& defaultValue)
 {
-    try{
-        node[key];
-    } catch(YAML::Exception &e) {
+    const YAML::Node* value = node.FindValue(key);
+    if (value == nullptr) {
         variable = defaultValue;
         return false;
     }
 
-    return tryRead(node[key], variable, defaultValue);
+    return tryRead(*value, variable, defaultValue);
+}
+
+namespace {
+    // The mesh of a TriangleAggregate being one of the loaded assets
+    std::unique_ptr<Object> buildObject(const ObjectDescription& object, SceneAssets& assets) {
+        const auto& [first, second, third] = object.Vectors;
+        const std::array<double, 6>& numbers = object.Numbers;
+
+        switch (object.Type) {
+            case ObjectType::Sphere:
+                return std::make_unique<Sphere>(first, numbers[0], Quaternion(numbers[1], numbers[2], numbers[3], numbers[4]));
+            case ObjectType::Cone:
+                return std::make_unique<Cone>(first, second, third);
+            case ObjectType::Plane:
+                return std::make_unique<Plane>(first, second, numbers[0]);
+            case ObjectType::Triangle: {
+                Vector normal = getThirdOrthogonalVector(second - first, third - first);
+                return std::make_unique<Triangle>(
+                        Vertex{first, normal, {numbers[0], numbers[1]}},
+                        Vertex{second, normal, {numbers[2], numbers[3]}},
+                        Vertex{third, normal, {numbers[4], numbers[5]}}
+                        );
+            }
+            case ObjectType::TriangleAggregate:
+                return std::make_unique<TriangleAggregate>(assets.takeMesh(object.FileName));
+            case ObjectType::Quadrilateral:
+                return std::make_unique<Quadrilateral>(first, second, third);
+            case ObjectType::Box:
+                return std::make_unique<Box>(first, second, third, numbers[0]);
+        }
+
+        return nullptr;
+    }
+
+    // The textures of the material, requested before it is built
+    void requestAssets(const MaterialDescription& description, SceneAssets& assets) {
+        if (! description.texture.empty())
+            assets.requestTexture(description.texture);
+        if (! description.specularMap.empty())
+            assets.requestTexture(description.specularMap, TexelFormat::R8);
+        if (! description.normalMap.empty())
+            assets.requestTexture(description.normalMap);
+    }
+
+    Material buildMaterial(const MaterialDescription& description) {
+        Material output;
+        output.color = description.color;
+
+        // Shared with the other materials using the same files, and already decoded with the other assets
+        if (! description.texture.empty())
+            output.texture = TextureCache::shared().get(description.texture);
+        // Only its red channel is read
+        if (! description.specularMap.empty())
+            output.specularMap = TextureCache::shared().get(description.specularMap, TexelFormat::R8);
+        if (! description.normalMap.empty())
+            output.normalMap = TextureCache::shared().get(description.normalMap);
+
+        output.ka = description.ka;
+        output.kd = description.kd;
+        output.ks = description.ks;
+        output.n = description.n;
+        output.index = description.index;
+        output.type = description.type;
+        return output;
+    }
 }
 
 /*
@@ -403,6 +382,68 @@ bool tryRead(const YAML::Node &node, const std::string& key, VariableType &varia
 */
 
 bool Raytracer::readScene(const std::string& inputFilename)
+{
+    SceneDescription description;
+
+    // The files of the scene are loaded while building it, and throw if one can not be read
+    auto build = [this, &description] () {
+        try {
+            buildScene(description);
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return false;
+        }
+        return true;
+    };
+
+    if (SceneDescription::isCompiled(inputFilename)) {
+        Statistics::PhaseTimer timer{Statistics::Phase::CompiledSceneRead};
+
+        try {
+            description = SceneDescription::readCompiled(inputFilename);
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return false;
+        }
+
+        if (! build())
+            return false;
+        std::cout << "Compiled scene: " << scene.getNumObjects() << " objects read." << std::endl;
+    }
+    else {
+        Statistics::PhaseTimer timer{Statistics::Phase::YamlParse};
+
+        if (! readYaml(inputFilename, description))
+            return false;
+
+        if (! build())
+            return false;
+        std::cout << "YAML parsing results: " << scene.getNumObjects() << " objects read." << std::endl;
+    }
+
+    TextureCache::shared().printSummary(std::cout);
+    return true;
+}
+
+bool Raytracer::compileScene(const std::string& inputFilename, const std::string& outputFilename)
+{
+    SceneDescription description;
+    if (! readYaml(inputFilename, description))
+        return false;
+
+    try {
+        description.writeCompiled(outputFilename);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return false;
+    }
+
+    std::cout << "Compiled " << description.Objects.size() << " objects and " << description.Lights.size()
+              << " lights to " << outputFilename << std::endl;
+    return true;
+}
+
+bool Raytracer::readYaml(const std::string& inputFilename, SceneDescription& description)
 {
     // Open file stream for reading and have the YAML module parse it
     std::ifstream fin(inputFilename.c_str());
@@ -410,6 +451,7 @@ bool Raytracer::readScene(const std::string& inputFilename)
         std::cerr << "Error: unable to open " << inputFilename << " for reading." << std::endl;
         return false;
     }
+
     try {
         YAML::Parser parser(fin);
         if (parser) {
@@ -417,54 +459,39 @@ bool Raytracer::readScene(const std::string& inputFilename)
             parser.GetNextDocument(doc);
 
             // Read scene configuration options
-            Mode mode;
-            int maxIterations;
-            int distmin, distmax;
-            bool renderSoftShadows;
-
-            tryRead(doc, "RenderMode", mode, Mode::PHONG);
-            tryRead(doc, "MaxIterations", maxIterations, 0);
-            tryRead(doc, "DistMin", distmin, 0);
-            tryRead(doc, "DistMax", distmax, 10000);
-            tryRead(doc, "SoftShadows", renderSoftShadows, false);
-
-            scene.setMode(mode);
-            scene.setMaxIterations(maxIterations);
-            scene.setNear(distmin);
-            scene.setFar(distmax);
-            scene.SoftShadows = renderSoftShadows;
-
-            if (! tryRead(doc, "GoochParameters", scene.goochIlluminationModel) && mode == Mode::GOOCH) {
-                std::cerr << "Warning: problem reading the gooch model parameters, using the default values" << std::endl;
-            }
+            SceneSettings& settings = description.Settings;
 
-            Camera camera{};
+            tryRead(doc, "RenderMode", settings.RenderMode, Mode::PHONG);
+            tryRead(doc, "MaxIterations", settings.MaxIterations, 0);
+            tryRead(doc, "DistMin", settings.Near, 0);
+            tryRead(doc, "DistMax", settings.Far, 10000);
+            tryRead(doc, "SoftShadows", settings.SoftShadows, false);
 
-            if (tryRead(doc, "Camera", camera)) {
-                scene.camera = camera;
+            if (! tryRead(doc, "GoochParameters", settings.Gooch) && settings.RenderMode == Mode::GOOCH) {
+                std::cerr << "Warning: problem reading the gooch model parameters, using the default values" << std::endl;
             }
-            else {
-                Vector eye{};
-                tryRead(doc, "Eye", eye, Vector{200, 200, 0});
-                scene.camera = Camera{eye};
+
+            if (! tryRead(doc, "Camera", settings.Camera)) {
+                tryRead(doc, "Eye", settings.Camera.Eye, Vector{200, 200, 0});
             }
 
-            try {
-                const YAML::Node& n = doc["SuperSampling"];
-                tryRead<unsigned int>(n, "factor", scene.superSamplingFactor, 1);
+            if (const YAML::Node* n = doc.FindValue("SuperSampling")) {
+                tryRead<unsigned int>(*n, "factor", settings.SuperSamplingFactor, 1);
+                tryRead(*n, "adaptive", settings.AdaptiveSuperSampling, false);
+                tryRead(*n, "threshold", settings.SuperSamplingThreshold, 0.1);
             }
-            catch (YAML::Exception & e) {
-                scene.superSamplingFactor = 1;
+            else {
+                settings.SuperSamplingFactor = 1;
+                settings.AdaptiveSuperSampling = false;
             }
 
-            try {
-                const YAML::Node& n = doc["SoftShadowsPrecision"];
-                tryRead<unsigned int>(n, "edge", scene.shadowEdgePrecision, 2);
-                tryRead<unsigned int>(n, "shade", scene.shadowShadePrecision, 3);
+            if (const YAML::Node* n = doc.FindValue("SoftShadowsPrecision")) {
+                tryRead<unsigned int>(*n, "edge", settings.ShadowEdgePrecision, 2);
+                tryRead<unsigned int>(*n, "shade", settings.ShadowShadePrecision, 3);
             }
-            catch (YAML::Exception & e) {
-                scene.shadowEdgePrecision = 2;
-                scene.shadowShadePrecision = 3;
+            else {
+                settings.ShadowEdgePrecision = 2;
+                settings.ShadowShadePrecision = 3;
             }
 
             bool shadowRefraction = false, refractedShadowsDefined = false;
@@ -475,39 +502,42 @@ bool Raytracer::readScene(const std::string& inputFilename)
 
 
                 if (shadowRefraction || refractedShadowsDefined) {
-                    scene.refractedShadows = refractedShadowsParameters;
+                    settings.RefractedShadows = refractedShadowsParameters;
                 }
             }
 
             // Read and parse the scene objects
-            const YAML::Node& sceneObjects = doc["Objects"];
-            if (sceneObjects.GetType() != YAML::CT_SEQUENCE) {
+            const YAML::Node* sceneObjects = doc.FindValue("Objects");
+            if (sceneObjects == nullptr || sceneObjects->GetType() != YAML::CT_SEQUENCE) {
                 std::cerr << "Error: expected a sequence of objects." << std::endl;
                 return false;
             }
-            for(YAML::Iterator it = sceneObjects.begin(); it != sceneObjects.end(); ++it) {
-                std::unique_ptr<Object> object;
-
-                // Only add object if it is recognized
-                if (tryRead(*it, object)) {
-                    scene.addObject(std::move(object));
+            for(YAML::Iterator it = sceneObjects->begin(); it != sceneObjects->end(); ++it) {
+                ObjectDescription object;
+                MaterialDescription material;
+
+                // Only add object if it is recognized, with its material
+                if (tryRead(*it, object) && tryRead(*it, "material", material)) {
+                    object.Material = static_cast<std::uint32_t>(description.Materials.size());
+                    description.Materials.push_back(std::move(material));
+                    description.Objects.push_back(std::move(object));
                 } else {
                     std::cerr << "Warning: found object of unknown type, ignored." << std::endl;
                 }
             }
 
             // Read and parse light definitions
-            const YAML::Node& sceneLights = doc["Lights"];
-            if (sceneObjects.GetType() != YAML::CT_SEQUENCE) {
+            const YAML::Node* sceneLights = doc.FindValue("Lights");
+            if (sceneLights == nullptr || sceneLights->GetType() != YAML::CT_SEQUENCE) {
                 std::cerr << "Error: expected a sequence of lights." << std::endl;
                 return false;
             }
-            for(YAML::Iterator it=sceneLights.begin(); it!=sceneLights.end(); ++it) {
-                std::unique_ptr<Light> light;
+            for(YAML::Iterator it=sceneLights->begin(); it!=sceneLights->end(); ++it) {
+                LightDescription light;
 
                 // Only add object if it is recognized
                 if (tryRead(*it, light)) {
-                    scene.addLight(std::move(light));
+                    description.Lights.push_back(light);
                 } else {
                     std::cerr << "Warning: found unreadable light, ignored." << std::endl;
                 }
@@ -521,15 +551,107 @@ bool Raytracer::readScene(const std::string& inputFilename)
         return false;
     }
 
-    std::cout << "YAML parsing results: " << scene.getNumObjects() << " objects read." << std::endl;
     return true;
 }
 
+void Raytracer::buildScene(const SceneDescription& description)
+{
+    const SceneSettings& settings = description.Settings;
+
+    scene.setMode(settings.RenderMode);
+    scene.setMaxIterations(settings.MaxIterations);
+    scene.setNear(settings.Near);
+    scene.setFar(settings.Far);
+    scene.SoftShadows = settings.SoftShadows;
+    scene.goochIlluminationModel = settings.Gooch;
+
+    scene.camera = Camera{settings.Camera.Eye, settings.Camera.Center, settings.Camera.Up};
+    scene.camera.ViewSize = settings.Camera.ViewSize;
+
+    scene.superSamplingFactor = settings.SuperSamplingFactor;
+    scene.adaptiveSuperSampling = settings.AdaptiveSuperSampling;
+    scene.superSamplingThreshold = settings.SuperSamplingThreshold;
+    scene.shadowEdgePrecision = settings.ShadowEdgePrecision;
+    scene.shadowShadePrecision = settings.ShadowShadePrecision;
+    scene.refractedShadows = settings.RefractedShadows;
+
+    // The files of the materials and of the objects loaded together, before anything is built
+    SceneAssets assets;
+    for (const MaterialDescription& material : description.Materials)
+        requestAssets(material, assets);
+    for (const ObjectDescription& object : description.Objects) {
+        if (object.Type == ObjectType::TriangleAggregate)
+            assets.requestMesh(object.FileName);
+    }
+    assets.load(std::cout);
+
+    // Every material built once, with its textures, and copied to the objects using it
+    std::vector<Material> materials;
+    materials.reserve(description.Materials.size());
+    for (const MaterialDescription& material : description.Materials)
+        materials.push_back(buildMaterial(material));
+
+    for (const ObjectDescription& objectDescription : description.Objects) {
+        std::unique_ptr<Object> object = buildObject(objectDescription, assets);
+        object->material = materials[objectDescription.Material];
+        scene.addObject(std::move(object));
+    }
+
+    for (const LightDescription& light : description.Lights)
+        scene.addLight(std::make_unique<Light>(light.Position, light.color, light.Size));
+}
+
 void Raytracer::renderToFile(const std::string& outputFilename)
 {
-    std::cout << "Tracing..." << std::endl;
-    Image img = scene.render();
-    std::cout << "Writing image to " << outputFilename << "..." << std::endl;
-    img.write_png(outputFilename.c_str());
+    // Float output, written unclamped for the post-processing
+    bool floatOutput = outputFilename.size() >= 4 && outputFilename.substr(outputFilename.size() - 4) == ".pfm";
+
+    if (scene.renderOptions.StreamOutput && floatOutput)
+        std::cerr << "Warning: the PFM output is not streamed, the image being written once rendered" << std::endl;
+
+    if (scene.renderOptions.StreamOutput && ! floatOutput) {
+        PngStreamWriter writer{outputFilename, static_cast<int>(scene.camera.ViewSize[0]), static_cast<int>(scene.camera.ViewSize[1])};
+        if (! writer.isOpen()) {
+            std::cerr << "Error: writing image to " << outputFilename << " failed." << std::endl;
+            return;
+        }
+
+        std::cout << "Tracing and writing image to " << outputFilename << "..." << std::endl;
+
+        scene.render([&writer] (RadianceImage& band, int) {
+            Statistics::PhaseTimer timer{Statistics::Phase::PngEncode};
+            writer.writeRows(band);
+        });
+
+        bool written;
+        {
+            Statistics::PhaseTimer timer{Statistics::Phase::PngEncode};
+            written = writer.finish();
+        }
+
+        if (! written) {
+            std::cerr << "Error: writing image to " << outputFilename << " failed." << std::endl;
+            return;
+        }
+    }
+    else {
+        std::cout << "Tracing..." << std::endl;
+        RadianceImage img = scene.render();
+        std::cout << "Writing image to " << outputFilename << "..." << std::endl;
+
+        if (floatOutput) {
+            if (! img.write_pfm(outputFilename.c_str())) {
+                std::cerr << "Error: writing image to " << outputFilename << " failed." << std::endl;
+                return;
+            }
+        }
+        else {
+            Statistics::PhaseTimer timer{Statistics::Phase::PngEncode};
+            img.write_png(outputFilename.c_str());
+        }
+    }
+
+    Statistics::printPhases(std::cout);
+    PagePool::shared().printSummary(std::cout);
     std::cout << "Done." << std::endl;
 }
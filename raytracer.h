@@ -20,16 +20,25 @@
 #include "triple.h"
 #include "light.h"
 #include "scene.h"
+#include "SceneDescription.h"
 #include "yaml/yaml.h"
 
 class Raytracer {
 private:
     Scene scene;
 
+    void buildScene(const SceneDescription& description);
+
 public:
     Raytracer() = default;
 
+    // Reads a YAML scene file, or a compiled scene file written by compileScene
     bool readScene(const std::string& inputFilename);
+    // Writes the YAML scene file as a compiled scene file, read without parsing the YAML again
+    static bool compileScene(const std::string& inputFilename, const std::string& outputFilename);
+    // Reads the description of a YAML scene file, without building its objects
+    static bool readYaml(const std::string& inputFilename, SceneDescription& description);
+    void setRenderOptions(const RenderOptions& options) { scene.renderOptions = options; }
     void renderToFile(const std::string& outputFilename);
 };
 
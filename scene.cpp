@@ -15,40 +15,51 @@
 //
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <stdexcept>
 #include "scene.h"
+#include "Statistics.h"
+#include "Heatmap.h"
 #include <vector>
 #include <cmath>
 #include <cassert>
+#include <chrono>
 
-template<typename Iterator, typename Operator>
-Iterator optimized_min_element(const Iterator& begin, const Iterator& end, Operator ope) {
-    std::vector<decltype(ope(*begin))> values;
-    values.reserve(std::distance(begin, end));
+Radiance Scene::trace(const Ray &ray, int iterations)
+{
+    return shade(findClosestHit(ray), iterations);
+}
 
-    for (auto it = begin; it != end; ++it)
-        values.push_back(ope(*it));
+Radiance Scene::traceZBuf(const Ray &ray)
+{
+    return shadeZBuf(findClosestHit(ray));
+}
 
-    auto minValueIter = std::min_element(values.begin(), values.end());
-    return begin + std::distance(values.begin(), minValueIter);
+Radiance Scene::traceNormals(const Ray &ray)
+{
+    return shadeNormals(findClosestHit(ray));
 }
 
+Radiance Scene::traceTextures(const Ray &ray)
+{
+    return shadeTextures(findClosestHit(ray));
+}
 
-Color Scene::trace(const Ray &ray, int iterations)
+Radiance Scene::shade(const ObjectHit &objectHit, int iterations)
 {
-    std::unique_ptr<Object>& object = getObjectHitBy(ray);
+    const auto& [object_hit, current_hit] = objectHit;
 
     // No hit? Return background color.
-    Hit current_hit = object->intersect(ray);
     if (current_hit == Hit::NO_HIT()) return Color(0.0, 0.0, 0.0);
 
-    Color output{};
+    const std::unique_ptr<Object>& object = *object_hit;
+    Radiance output{};
 
     if (object->material.type == MaterialType::REFRACTION && iterations > 0) {
 
         output += computeIllumination(current_hit, specular, object);
-        output += computeRefraction(current_hit, object->material, iterations) * object->getColorOnPosition(current_hit.Position);
+        output += computeRefraction(current_hit, object->material, iterations) * object->getColorOnHit(current_hit);
     }
     else {
 
@@ -62,20 +73,14 @@ Color Scene::trace(const Ray &ray, int iterations)
     return output;
 }
 
-Color Scene::traceZBuf(const Ray &ray)
+Radiance Scene::shadeZBuf(const ObjectHit &objectHit)
 {
-    auto hit_iterator = optimized_min_element(
-            std::begin(objects), std::end(objects),
-            [&ray](const std::unique_ptr<Object>& o) { return Hit(o->intersect(ray)).Distance; }
-    );
+    const Hit& current_hit = objectHit.second;
 
     // No hit? Return background color.
-    Hit current_hit = (*hit_iterator)->intersect(ray);
     if (current_hit == Hit::NO_HIT()) return Color(0.0, 0.0, 0.0);
 
-    std::unique_ptr<Object>& obj = *hit_iterator;
-
-    Color output{};
+    Radiance output{};
 
     if (current_hit.Distance < far && current_hit.Distance > near) {
         auto normalizedDistance = 1.0 - (current_hit.Distance - near) / (far - near);
@@ -86,40 +91,29 @@ Color Scene::traceZBuf(const Ray &ray)
 
     return output;
 }
-Color Scene::traceNormals(const Ray &ray)
+
+Radiance Scene::shadeNormals(const ObjectHit &objectHit)
 {
-    auto hit_iterator = optimized_min_element(
-            std::begin(objects), std::end(objects),
-            [&ray](const std::unique_ptr<Object>& o) { return Hit(o->intersect(ray)).Distance; }
-    );
+    const Hit& current_hit = objectHit.second;
 
     // No hit? Return background color.
-    Hit current_hit = (*hit_iterator)->intersect(ray);
     if (current_hit == Hit::NO_HIT()) return Color(0.0, 0.0, 0.0);
 
-    std::unique_ptr<Object>& obj = *hit_iterator;
+    Radiance output{};
 
-    Color output{};
-
-    output = Color{(current_hit.Normal + Vector{1, 1, 1}) / 2};
+    output = Radiance{(current_hit.Normal + Vector{1, 1, 1}) / 2};
 
     return output;
 }
 
-Color Scene::traceTextures(const Ray &ray)
+Radiance Scene::shadeTextures(const ObjectHit &objectHit)
 {
-    auto hit_iterator = optimized_min_element(
-            std::begin(objects), std::end(objects),
-            [&ray](const std::unique_ptr<Object>& o) { return Hit(o->intersect(ray)).Distance; }
-    );
+    const auto& [obj, current_hit] = objectHit;
 
     // No hit? Return background color.
-    Hit current_hit = (*hit_iterator)->intersect(ray);
     if (current_hit == Hit::NO_HIT()) return Color(0.0, 0.0, 0.0);
 
-    std::unique_ptr<Object>& obj = *hit_iterator;
-
-    auto uv = obj->getTextureCoordinatesFor(current_hit.Position);
+    auto uv = (*obj)->getTextureCoordinatesFor(current_hit);
 
     // to better fit the UV repeating system of the Image class
     for (std::size_t i = 0; i < 2; ++i) {
@@ -132,59 +126,361 @@ Color Scene::traceTextures(const Ray &ray)
     return Color{uv[0], uv[1], 0};
 }
 
-Image Scene::render()
+namespace {
+    // Largest difference between the displayed colors on any of the channels, the radiances being clamped
+    double contrast(const std::array<Radiance, 4>& radiances) {
+        std::array<Color, 4> colors{radiances[0].clamped(), radiances[1].clamped(), radiances[2].clamped(), radiances[3].clamped()};
+        double output = 0;
+
+        for (std::size_t channel = 0; channel < 3; ++channel) {
+            auto [min, max] = std::minmax<double>({colors[0][channel], colors[1][channel], colors[2][channel], colors[3][channel]});
+            output = std::max(output, max - min);
+        }
+
+        return output;
+    }
+}
+
+RadianceImage Scene::render()
 {
-    Image img(camera.ViewSize[0], camera.ViewSize[1]);
+    RadianceImage img;
+    renderBands(static_cast<int>(camera.ViewSize[1]), [&img] (RadianceImage& band, int) { img = std::move(band); });
+    return img;
+}
 
-    Color (*traceFunction)(Scene*, const Ray&) = nullptr;
+void Scene::render(const BandWriter& writeBand)
+{
+    renderBands(0, writeBand);
+}
+
+void Scene::renderBands(int bandHeight, const BandWriter& writeBand)
+{
+    Radiance (*shadeFunction)(Scene*, const ObjectHit&) = nullptr;
 
     switch (mode) {
         case Mode::GOOCH:
         case Mode::PHONG:
-            traceFunction = [] (Scene* scene, const Ray& ray) { return scene->trace(ray, scene->maxIterations); };
+            shadeFunction = [] (Scene* scene, const ObjectHit& hit) { return scene->shade(hit, scene->maxIterations); };
             break;
         case Mode::ZBUFFER:
-            traceFunction = [] (Scene* scene, const Ray& ray) { return scene->traceZBuf(ray); };
+            shadeFunction = [] (Scene* scene, const ObjectHit& hit) { return scene->shadeZBuf(hit); };
             break;
         case Mode::NORMAL:
-            traceFunction = [] (Scene* scene, const Ray& ray) { return scene->traceNormals(ray); };
+            shadeFunction = [] (Scene* scene, const ObjectHit& hit) { return scene->shadeNormals(hit); };
             break;
         case Mode::TEXTURE:
-            traceFunction = [] (Scene* scene, const Ray& ray) { return scene->traceTextures(ray); };
+            shadeFunction = [] (Scene* scene, const ObjectHit& hit) { return scene->shadeTextures(hit); };
             break;
     }
 
-    if (! traceFunction) {
+    if (! shadeFunction) {
         throw std::invalid_argument("Invalid rendering mode : " + std::to_string(mode));
     }
 
+    buildObjectHierarchy();
+
     if (refractedShadows.has_value() && (mode == GOOCH || mode == PHONG)) {
         computeRefractedShadows();
         std::cout << "refracted shadows computed" << std::endl;
     }
 
-    int w = img.width();
-    int h = img.height();
+    int w = static_cast<int>(camera.ViewSize[0]);
+    int h = static_cast<int>(camera.ViewSize[1]);
     double delta = 1.0 / (superSamplingFactor+1);
     unsigned int rayPerPixel = superSamplingFactor * superSamplingFactor;
-    #pragma omp parallel for default(none) shared(traceFunction, img, h, w, delta, rayPerPixel)
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            Color pixelColor{};
-
-            for (int i = 0; i < superSamplingFactor; i++) {
-                for (int j = 0; j < superSamplingFactor; j++) {
-                    Ray ray(camera.Eye(), (camera.ViewDirection(x, y, delta*(i+1), delta*(j+1))).normalized());
-                    pixelColor += traceFunction(this, ray) / rayPerPixel;
+
+    // The cone of a sample covers its share of the pixel, for the texture filtering
+    double sampleSpread = camera.PixelSpread() / superSamplingFactor;
+
+    auto primaryRay = [this, delta, sampleSpread] (int x, int y, int i, int j) {
+        return Ray(camera.Eye(), (camera.ViewDirection(x, y, delta*(i+1), delta*(j+1))).normalized(), 0, sampleSpread);
+    };
+
+    // Sample on the top left corner of the pixel, shared with the three other pixels around the corner
+    auto cornerRay = [this] (int x, int y) {
+        return Ray(camera.Eye(), (camera.ViewDirection(x, y, 0, 1)).normalized(), 0, camera.PixelSpread());
+    };
+
+    // Cost of every pixel for the heatmap, measured only when one is requested
+    bool measureCosts = ! renderOptions.HeatmapFile.empty();
+    CostMetric costMetric = renderOptions.HeatmapMetric;
+    BaseImage<double> pixelCosts;
+
+    if (measureCosts) {
+        if (costMetric != CostMetric::Time && ! Statistics::Enabled) {
+            std::cerr << "Warning: the ray and intersection test counters are compiled out, using the time for the heatmap" << std::endl;
+            costMetric = CostMetric::Time;
+        }
+        pixelCosts = BaseImage<double>(w, h);
+    }
+
+    // Counters summed by the ray and the intersection test metrics
+    using Statistics::Counter;
+    static constexpr std::array<Counter, 4> RayCounters{
+            Counter::PrimaryRays, Counter::ReflectionRays, Counter::RefractionRays, Counter::ShadowRays};
+    static constexpr std::array<Counter, 8> TestCounters{
+            Counter::SphereTests, Counter::ConeTests, Counter::TriangleTests, Counter::QuadrilateralTests,
+            Counter::PlaneTests, Counter::BoxTests, Counter::MeshTests, Counter::MeshTriangleTests};
+
+    // Cost of the work done so far by the calling thread
+    auto currentCost = [costMetric] () -> double {
+        if (costMetric == CostMetric::Time)
+            return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        const Statistics::Counts& counts = Statistics::threadCounts();
+        std::uint64_t output = 0;
+        auto add = [&counts, &output] (const auto& counters) {
+            for (Counter counter : counters)
+                output += counts[static_cast<std::size_t>(counter)];
+        };
+
+        if (costMetric == CostMetric::Rays)
+            add(RayCounters);
+        else
+            add(TestCounters);
+        return static_cast<double>(output);
+    };
+
+    /*
+     * Traces the primary rays rayAt(0) to rayAt(count - 1), colors receiving their radiances. When measuring the costs,
+     * costs receives the cost of every ray, the cost of tracing a packet being shared between its rays.
+     */
+    auto traceRays = [this, &shadeFunction, &currentCost, measureCosts] (std::size_t count, const auto& rayAt,
+                                                                        std::vector<Radiance>& colors, std::vector<double>& costs) {
+        colors.resize(count);
+        costs.assign(measureCosts ? count : 0, 0);
+
+        if (renderOptions.PacketTracing) {
+            // Only the first bounce is traced as a packet
+            for (std::size_t first = 0; first < count; first += RayPacket::Size) {
+                RayPacket::Mask activeRays = 0;
+
+                for (std::size_t ray = 0; ray < RayPacket::Size; ++ray) {
+                    if (first + ray < count)
+                        activeRays |= RayPacket::Mask{1} << ray;
+                }
+
+                // The rays past the end repeat the last one and stay inactive
+                RayPacket rays{[&rayAt, first, count] (std::size_t ray) { return rayAt(std::min(first + ray, count - 1)); }};
+
+                double packetStart = measureCosts ? currentCost() : 0;
+                ADD_STATISTIC(PrimaryRays, std::min(count - first, RayPacket::Size));
+
+                RayPacket::Lanes<const std::unique_ptr<Object>*> objectsHit{};
+                findClosestHits(rays, activeRays, objectsHit);
+
+                double packetCost = measureCosts ? (currentCost() - packetStart) / std::min(count - first, RayPacket::Size) : 0;
+
+                for (std::size_t ray = 0; ray < RayPacket::Size; ++ray) {
+                    if (! RayPacket::contains(activeRays, ray))
+                        continue;
+
+                    double start = measureCosts ? currentCost() : 0;
+                    colors[first + ray] = shadeFunction(this, {objectsHit[ray], rays.Hits[ray]});
+                    if (measureCosts)
+                        costs[first + ray] = packetCost + currentCost() - start;
+                }
+            }
+        }
+        else {
+            for (std::size_t ray = 0; ray < count; ++ray) {
+                double start = measureCosts ? currentCost() : 0;
+                COUNT_STATISTIC(PrimaryRays);
+                colors[ray] = shadeFunction(this, findClosestHit(rayAt(ray)));
+                if (measureCosts)
+                    costs[ray] = currentCost() - start;
+            }
+        }
+    };
+
+    // The pixels of a tile being only written by its thread, their costs are summed without synchronisation
+    auto addCosts = [&pixelCosts, measureCosts] (const std::vector<double>& costs, const auto& pixelOf) {
+        if (! measureCosts)
+            return;
+
+        for (std::size_t ray = 0; ray < costs.size(); ++ray) {
+            std::array<int, 2> pixel = pixelOf(ray);
+            pixelCosts(pixel[0], pixel[1]) += costs[ray];
+        }
+    };
+
+    // Current band of the image, holding the rows [bandY, bandY + band.height())
+    RadianceImage band;
+    int bandY = 0;
+    std::atomic<std::size_t> tracedRayCount{0}, refinedPixelCount{0};
+
+    // Traces the whole superSamplingFactor x superSamplingFactor grid of every pixel,
+    // the rays of neighbouring pixels of a row being traced together
+    auto renderTileFixed = [this, &traceRays, &addCosts, &primaryRay, &band, &bandY, &tracedRayCount, rayPerPixel] (const Tile& tile) {
+        std::vector<Radiance> colors, pixelColors;
+        std::vector<double> costs;
+
+        for (int y = tile.Y; y < tile.Y + tile.Height; y++) {
+            pixelColors.assign(tile.Width, Radiance{});
+
+            for (unsigned int i = 0; i < superSamplingFactor; i++) {
+                for (unsigned int j = 0; j < superSamplingFactor; j++) {
+                    traceRays(tile.Width, [&primaryRay, &tile, y, i, j] (std::size_t x) {
+                        return primaryRay(tile.X + static_cast<int>(x), y, i, j);
+                    }, colors, costs);
+                    addCosts(costs, [&tile, y] (std::size_t x) { return std::array<int, 2>{tile.X + static_cast<int>(x), y}; });
+
+                    for (int x = 0; x < tile.Width; x++)
+                        pixelColors[x] += colors[x] / rayPerPixel;
+                }
+            }
+
+            // The tiles being disjoint, no other thread writes these pixels
+            for (int x = 0; x < tile.Width; x++)
+                band(tile.X + x, y - bandY) = pixelColors[x];
+        }
+
+        tracedRayCount += static_cast<std::size_t>(tile.Width) * tile.Height * rayPerPixel;
+    };
+
+    /*
+     * Pixel corners of the current band for the adaptive supersampling, rows [bandY, bandY + band.height()]. Every
+     * corner is traced once, before the pixels of the band: a corner on the border of two tiles is traced by the tile
+     * below right of it, the last column and row of corners by the tiles along them. The last row is kept as the first
+     * one of the next band.
+     */
+    RadianceImage bandCorners;
+
+    auto traceTileCorners = [&traceRays, &addCosts, &cornerRay, &bandCorners, &bandY, &tracedRayCount, w, h] (const Tile& tile) {
+        std::vector<Radiance> colors;
+        std::vector<double> costs;
+        int bandEnd = bandY + bandCorners.height() - 1;
+        int endX = tile.X + tile.Width == w ? w + 1 : tile.X + tile.Width;
+        int firstY = tile.Y == bandY && bandY > 0 ? tile.Y + 1 : tile.Y;
+        int endY = tile.Y + tile.Height == bandEnd ? bandEnd + 1 : tile.Y + tile.Height;
+
+        for (int y = firstY; y < endY; y++) {
+            traceRays(static_cast<std::size_t>(endX - tile.X), [&cornerRay, &tile, y] (std::size_t x) {
+                return cornerRay(tile.X + static_cast<int>(x), y);
+            }, colors, costs);
+            // The cost of a corner goes to the pixel below right of it, that of the last column and row of the image to
+            // the pixel before it
+            addCosts(costs, [&tile, y, w, h] (std::size_t x) {
+                return std::array<int, 2>{std::min(tile.X + static_cast<int>(x), w - 1), std::min(y, h - 1)};
+            });
+
+            for (int x = tile.X; x < endX; x++)
+                bandCorners(x, y - bandY) = colors[x - tile.X];
+        }
+
+        tracedRayCount += static_cast<std::size_t>(endX - tile.X) * (endY - firstY);
+    };
+
+    /*
+     * Once the corners of the band are traced, traces the whole superSamplingFactor x superSamplingFactor grid only
+     * in the pixels whose corners differ by more than superSamplingThreshold. The other pixels take the mean of their
+     * corners, about one ray per pixel.
+     */
+    auto renderTileAdaptive = [this, &traceRays, &addCosts, &primaryRay, &bandCorners, &band, &bandY, &tracedRayCount, &refinedPixelCount, rayPerPixel] (const Tile& tile) {
+        std::vector<Radiance> colors;
+        std::vector<double> costs;
+        std::vector<std::array<int, 2>> refinedPixels;
+
+        for (int y = tile.Y - bandY; y < tile.Y + tile.Height - bandY; y++) {
+            for (int x = tile.X; x < tile.X + tile.Width; x++) {
+                std::array<Radiance, 4> pixelCorners{
+                        bandCorners(x, y), bandCorners(x + 1, y), bandCorners(x, y + 1), bandCorners(x + 1, y + 1)};
+
+                if (contrast(pixelCorners) > superSamplingThreshold)
+                    refinedPixels.push_back({x, y + bandY});
+                else
+                    band(x, y) = (pixelCorners[0] + pixelCorners[1] + pixelCorners[2] + pixelCorners[3]) / 4;
+            }
+        }
+
+        traceRays(refinedPixels.size() * rayPerPixel, [this, &primaryRay, &refinedPixels, rayPerPixel] (std::size_t ray) {
+            const std::array<int, 2>& pixel = refinedPixels[ray / rayPerPixel];
+            int sample = static_cast<int>(ray % rayPerPixel);
+            return primaryRay(pixel[0], pixel[1], sample / superSamplingFactor, sample % superSamplingFactor);
+        }, colors, costs);
+        addCosts(costs, [&refinedPixels, rayPerPixel] (std::size_t ray) { return refinedPixels[ray / rayPerPixel]; });
+
+        for (std::size_t pixel = 0; pixel < refinedPixels.size(); ++pixel) {
+            Radiance pixelColor{};
+            for (std::size_t sample = 0; sample < rayPerPixel; ++sample)
+                pixelColor += colors[pixel * rayPerPixel + sample] / rayPerPixel;
+
+            band(refinedPixels[pixel][0], refinedPixels[pixel][1] - bandY) = pixelColor;
+        }
+
+        tracedRayCount += refinedPixels.size() * rayPerPixel;
+        refinedPixelCount += refinedPixels.size();
+    };
+
+    std::function<void(const Tile&)> renderTile = adaptiveSuperSampling
+            ? std::function<void(const Tile&)>{renderTileAdaptive} : std::function<void(const Tile&)>{renderTileFixed};
+
+    TileScheduler scheduler{w, h, renderOptions.TileSize, renderOptions.ThreadCount};
+    int tileSize = std::max(renderOptions.TileSize, 1);
+
+    if (bandHeight <= 0) {
+        // Smallest band of whole tile rows giving every thread a few tiles to share
+        int tilesPerRow = (w + tileSize - 1) / tileSize;
+        int bandTileRows = (4 * static_cast<int>(scheduler.threadCount()) + tilesPerRow - 1) / tilesPerRow;
+        bandHeight = bandTileRows * tileSize;
+    }
+    else {
+        // The bands must not cut the tiles
+        bandHeight = (bandHeight + tileSize - 1) / tileSize * tileSize;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::size_t bandCount = 0;
+
+    {
+        Statistics::PhaseTimer timer{Statistics::Phase::Tracing};
+
+        for (bandY = 0; bandY < h; bandY += bandHeight, bandCount++) {
+            band = RadianceImage(w, std::min(bandHeight, h - bandY));
+
+            if (adaptiveSuperSampling) {
+                RadianceImage corners{w + 1, band.height() + 1};
+                if (bandY > 0) {
+                    for (int x = 0; x <= w; x++)
+                        corners(x, 0) = bandCorners(x, bandCorners.height() - 1);
                 }
+
+                bandCorners = std::move(corners);
+                scheduler.run(traceTileCorners, bandY, bandY + bandHeight);
             }
 
-            #pragma omp critical
-            img(x, y) = pixelColor;
+            scheduler.run(renderTile, bandY, bandY + bandHeight);
+            writeBand(band, bandY);
         }
     }
 
-    return img;
+    std::chrono::duration<double> renderTime = std::chrono::steady_clock::now() - start;
+    std::size_t primaryRayCount = tracedRayCount;
+
+    std::cout << "Rendered " << primaryRayCount << " primary rays in " << renderTime.count() * 1000 << " ms: "
+              << primaryRayCount / renderTime.count() << " rays/s ("
+              << (renderOptions.PacketTracing ? "packets of " + std::to_string(RayPacket::Size) + " rays" : "scalar") << ")" << std::endl;
+
+    if (adaptiveSuperSampling) {
+        std::cout << "Adaptive supersampling: " << static_cast<double>(primaryRayCount) / (static_cast<std::size_t>(w) * h)
+                  << " samples per pixel on average, " << 100.0 * refinedPixelCount / (static_cast<std::size_t>(w) * h)
+                  << "% of the pixels refined to " << rayPerPixel << " samples" << std::endl;
+    }
+
+    scheduler.printSummary(std::cout);
+
+    if (measureCosts) {
+        Heatmap heatmap{pixelCosts};
+        std::cout << "Heatmap of the " << costMetricName(costMetric) << " per pixel: " << heatmap.meanCost() << " on average, "
+                  << heatmap.scale() << " at the top of the scale, written to " << renderOptions.HeatmapFile << std::endl;
+        heatmap.toImage().write_png(renderOptions.HeatmapFile.c_str());
+    }
+    if (bandCount > 1) {
+        std::cout << "Rendered by " << bandCount << " bands of " << bandHeight << " rows, "
+                  << static_cast<std::size_t>(w) * bandHeight * sizeof(Radiance) / 1024 << " KiB of pixels" << std::endl;
+    }
+    if (! renderOptions.TileTimingsFile.empty() && ! scheduler.writeTimings(renderOptions.TileTimingsFile))
+        std::cerr << "Warning: unable to write the tile timings to " << renderOptions.TileTimingsFile << std::endl;
 }
 
 void Scene::addObject(std::unique_ptr<Object>&& o)
@@ -214,25 +510,88 @@ void Scene::setFar(int f){
     far = f;
 }
 
-std::unique_ptr<Object>& Scene::getObjectHitBy(const Ray& ray) {
-    auto hit_iterator = optimized_min_element(
-            std::begin(objects), std::end(objects),
-            [&ray](const std::unique_ptr<Object>& o) { return o->intersect(ray).Distance; }
-    );
+void Scene::buildObjectHierarchy() {
+    Statistics::PhaseTimer timer{Statistics::Phase::HierarchyBuild};
+    std::vector<BoundingBox> objectBounds;
+    boundedObjects.clear();
+    unboundedObjects.clear();
+
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        std::optional<BoundingBox> bounds = objects[i]->getBoundingBox();
 
-    return *hit_iterator;
+        if (bounds.has_value()) {
+            objectBounds.push_back(bounds.value());
+            boundedObjects.push_back(i);
+        }
+        else {
+            unboundedObjects.push_back(i);
+        }
+    }
+
+    objectHierarchy = BoundingVolumeHierarchy(objectBounds);
 }
 
-std::unique_ptr<Object>& Scene::getObjectHitBy(const Ray& ray, const std::unique_ptr<Object> &object_ignored) {
-    auto hit_iterator = optimized_min_element(
-            std::begin(objects), std::end(objects),
-            [&ray, &object_ignored](const std::unique_ptr<Object>& o) {
-                if (o == object_ignored) return Hit::NO_HIT().Distance;
-                return o->intersect(ray).Distance;
-            }
-    );
+Scene::ObjectHit Scene::findClosestHit(const Ray& ray, const Object* object_ignored) const {
+    ObjectHit closest{nullptr, Hit::NO_HIT()};
+    double closestDistance = Hit::NO_HIT().Distance;
+
+    auto intersectObject = [this, &ray, object_ignored, &closest] (std::size_t objectIndex, double& maxDistance) {
+        if (objects[objectIndex].get() == object_ignored) return;
+
+        Hit hit = objects[objectIndex]->intersect(ray);
+        if (hit.Distance < maxDistance) {
+            maxDistance = hit.Distance;
+            closest.first = &objects[objectIndex];
+            closest.second = hit;
+        }
+    };
+
+    // Planes first, they are few and give an early bound to the traversal
+    for (std::size_t objectIndex : unboundedObjects)
+        intersectObject(objectIndex, closestDistance);
+
+    objectHierarchy.intersect(ray, closestDistance, [this, &intersectObject] (std::size_t primitive, double& maxDistance) {
+        intersectObject(boundedObjects[primitive], maxDistance);
+    });
+
+    return closest;
+}
+
+bool Scene::isOccluded(const Ray& ray, double maxDistance, const Object* object_ignored) const {
+    COUNT_STATISTIC(ShadowRays);
+    auto occludedBy = [this, &ray, object_ignored] (std::size_t objectIndex, double maxDistance) {
+        return objects[objectIndex].get() != object_ignored && objects[objectIndex]->occludes(ray, maxDistance);
+    };
+
+    for (std::size_t objectIndex : unboundedObjects) {
+        if (occludedBy(objectIndex, maxDistance))
+            return true;
+    }
 
-    return *hit_iterator;
+    return objectHierarchy.occluded(ray, maxDistance, [this, &occludedBy] (std::size_t primitive, double maxDistance) {
+        return occludedBy(boundedObjects[primitive], maxDistance);
+    });
+}
+
+void Scene::findClosestHits(RayPacket &packet, RayPacket::Mask activeRays,
+                            RayPacket::Lanes<const std::unique_ptr<Object>*> &objectsHit) const {
+    objectsHit.fill(nullptr);
+
+    auto intersectObject = [this, &packet, &objectsHit] (std::size_t objectIndex, RayPacket::Mask rays) {
+        RayPacket::Mask closer = objects[objectIndex]->intersectPacket(packet, rays);
+
+        for (std::size_t ray = 0; ray < RayPacket::Size; ++ray) {
+            if (RayPacket::contains(closer, ray))
+                objectsHit[ray] = &objects[objectIndex];
+        }
+    };
+
+    for (std::size_t objectIndex : unboundedObjects)
+        intersectObject(objectIndex, activeRays);
+
+    objectHierarchy.intersect(packet, activeRays, [this, &intersectObject] (std::size_t primitive, RayPacket::Mask rays) {
+        intersectObject(boundedObjects[primitive], rays);
+    });
 }
 
 float Scene::getLightFactorFor(const std::unique_ptr<Light>& light, const Hit& hit, const std::unique_ptr<Object> &object_hit) {
@@ -245,14 +604,8 @@ float Scene::getLightFactorFor(const std::unique_ptr<Light>& light, const Hit& h
     Vector dPosition = hit.Position + positionToLight * 0.1;
     Ray newRay = Ray(dPosition, positionToLight);
 
-    std::unique_ptr<Object>& newObject = getObjectHitBy(newRay, object_hit);
-    Hit current_hit_new = newObject->intersect(newRay);
-
-    if (object_hit == newObject)
-        current_hit_new = Hit::NO_HIT();
-
     if ((! SoftShadows) || light->Size == 0) {
-        return current_hit_new.Distance >= (light->Position - dPosition).norm() ? 1 : 0;
+        return isOccluded(newRay, (light->Position - dPosition).norm(), object_hit.get()) ? 0 : 1;
     }
 
     Vector lightPositionDeltaDirection = getAnyOrthogonalVector(newRay.Direction).normalized();
@@ -260,29 +613,28 @@ float Scene::getLightFactorFor(const std::unique_ptr<Light>& light, const Hit& h
 
     float softLightFactor = 0;
 
-    for (std::size_t i = 0; i < lightSampleNumber; ++i) {
+    for (int i = 0; i < lightSampleNumber; ++i) {
         Vector dLightPosition = rotateAround(lightPositionDelta, newRay.Direction, (360.f * i) / lightSampleNumber);
 
-        for (std::size_t j = 1; j <= lightSubSampleNumber; ++j) {
+        for (int j = 1; j <= lightSubSampleNumber; ++j) {
 
-            Ray borderRay{dPosition, light->Position + (dLightPosition * (static_cast<float>(j) / lightSubSampleNumber)) - dPosition};
-            std::unique_ptr<Object> &objectHit = getObjectHitBy(borderRay);
+            Vector samplePosition = light->Position + (dLightPosition * (static_cast<float>(j) / lightSubSampleNumber));
+            Ray borderRay{dPosition, samplePosition - dPosition};
 
-            if (objectHit->intersect(borderRay) == Hit::NO_HIT())
+            if (! isOccluded(borderRay, (samplePosition - dPosition).norm()))
                 softLightFactor++;
-            else
-                softLightFactor += objectHit->intersect(borderRay).Distance /
-                                   (light->Position + dLightPosition - dPosition).norm();
         }
     }
 
     return softLightFactor / static_cast<float>(lightSampleNumber * lightSubSampleNumber);
 }
 
-Color Scene::computeReflection(const Hit& current_hit, const Material& material, int iterations) {
+Radiance Scene::computeReflection(const Hit& current_hit, const Material& material, int iterations) {
 
     Vector dir = -rotateAround(current_hit.Source.Direction, current_hit.Normal, 180);
-    Ray reflected{current_hit.Position + dir * 0.1, dir};
+    // The cone goes on from the footprint on the surface, the curvature of the surface being ignored
+    Ray reflected{current_hit.Position + dir * 0.1, dir, current_hit.Source.footprintAt(current_hit.Distance), current_hit.Source.ConeSpread};
+    COUNT_STATISTIC(ReflectionRays);
     return trace(reflected, iterations - 1) * material.ks;
 }
 
@@ -311,14 +663,16 @@ Vector getRefractedDirection(const Hit& current_hit, const Material& material) {
         return Vector{0, 0, 0};
 }
 
-Color Scene::computeRefraction(const Hit& current_hit, const Material& material, int iterations) {
+Radiance Scene::computeRefraction(const Hit& current_hit, const Material& material, int iterations) {
 
-    Color output{};
+    Radiance output{};
 
     Vector refractedDirection = getRefractedDirection(current_hit, material);
 
     if (refractedDirection != Vector{0, 0, 0}) {
-        output += trace(Ray{current_hit.Position + refractedDirection * 0.1, refractedDirection}, iterations - 1);
+        COUNT_STATISTIC(RefractionRays);
+        output += trace(Ray{current_hit.Position + refractedDirection * 0.1, refractedDirection,
+                            current_hit.Source.footprintAt(current_hit.Distance), current_hit.Source.ConeSpread}, iterations - 1);
     }
     else {
         output += computeReflection(current_hit, material, iterations);
@@ -328,7 +682,7 @@ Color Scene::computeRefraction(const Hit& current_hit, const Material& material,
 }
 
 
-Color Scene::computeIllumination(const Hit &hit, Scene::IlluminationType illumination, const std::unique_ptr<Object> &object_hit) {
+Radiance Scene::computeIllumination(const Hit &hit, Scene::IlluminationType illumination, const std::unique_ptr<Object> &object_hit) {
     if (mode == Mode::PHONG)
         return computePhong(hit, illumination, object_hit);
     if (mode == Mode::GOOCH)
@@ -337,11 +691,11 @@ Color Scene::computeIllumination(const Hit &hit, Scene::IlluminationType illumin
     return Color{0, 0, 0};
 }
 
-Color Scene::computePhong(const Hit& current_hit, Scene::IlluminationType illumination, const std::unique_ptr<Object> &object_hit) {
+Radiance Scene::computePhong(const Hit& current_hit, Scene::IlluminationType illumination, const std::unique_ptr<Object> &object_hit) {
 
-    Color output{};
-    Color colorOnHit = object_hit->getColorOnPosition(current_hit.Position);
-    double specularOnHit = object_hit->getSpecularOnPosition(current_hit.Position);
+    Radiance output{};
+    Color colorOnHit = object_hit->getColorOnHit(current_hit);
+    double specularOnHit = object_hit->getSpecularOnHit(current_hit);
 
     if (illumination & ambient)
         output += colorOnHit * object_hit->material.ka;
@@ -358,7 +712,7 @@ Color Scene::computePhong(const Hit& current_hit, Scene::IlluminationType illumi
                     output += lightFactor * light_source->computeSpecularPhongAt(current_hit, object_hit->material, specularOnHit);
             }
 
-            std::array<double, 3> additionalLightFactor = object_hit->getAdditionalLightFactor(*light_source, current_hit.Position);
+            std::array<double, 3> additionalLightFactor = object_hit->getAdditionalLightFactor(*light_source, current_hit);
 
 
             for (std::size_t i = 0; i < 3; ++i) {
@@ -371,10 +725,10 @@ Color Scene::computePhong(const Hit& current_hit, Scene::IlluminationType illumi
     return output;
 }
 
-Color Scene::computeGooch(const Hit &current_hit, Scene::IlluminationType illumination, const std::unique_ptr<Object> &object_hit) {
-    Color output{};
-    Color colorOnHit = object_hit->getColorOnPosition(current_hit.Position);
-    double specularOnHit = object_hit->getSpecularOnPosition(current_hit.Position);
+Radiance Scene::computeGooch(const Hit &current_hit, Scene::IlluminationType illumination, const std::unique_ptr<Object> &object_hit) {
+    Radiance output{};
+    Color colorOnHit = object_hit->getColorOnHit(current_hit);
+    double specularOnHit = object_hit->getSpecularOnHit(current_hit);
 
     if (illumination & diffuse || illumination & specular) {
         for (std::unique_ptr<Light> &light_source : lights) {
@@ -393,9 +747,10 @@ void Scene::setMaxIterations(int iterations) {
 }
 
 void Scene::computeRefractedShadows() {
+    Statistics::PhaseTimer timer{Statistics::Phase::RefractedShadows};
 
     #pragma omp parallel for
-    for (int i = 0; i < objects.size(); ++i) {
+    for (std::size_t i = 0; i < objects.size(); ++i) {
         const auto &target = objects[i];
         if (target->material.type == MaterialType::REFRACTION) {
             for (const auto &light : lights) {
@@ -442,13 +797,12 @@ bool Scene::computeRefractedShadowsAt(
 
     Ray currentRay{light->Position, currentDirection};
 
-    const std::unique_ptr<Object>& objectHit = getObjectHitBy(currentRay);
+    auto [objectHit, current_hit] = findClosestHit(currentRay);
 
     // No hit? Return background color.
-    Hit current_hit = objectHit->intersect(currentRay);
-    if (current_hit == Hit::NO_HIT() || objectHit != target) return false;
+    if (current_hit == Hit::NO_HIT() || *objectHit != target) return false;
 
-    computeRefractedLightBeam(light, current_hit, objectHit, objectHit->getColorOnPosition(current_hit.Position));
+    computeRefractedLightBeam(light, current_hit, *objectHit, (*objectHit)->getColorOnHit(current_hit));
 
     return true;
 }
@@ -462,19 +816,18 @@ void Scene::computeRefractedLightBeam(const std::unique_ptr<Light> &light, const
         if (refractedDirection == Vector{0, 0, 0}) return;
 
         Ray nextRay{hit.Position + refractedDirection * 0.001, refractedDirection};
-        const std::unique_ptr<Object>& nextObjectHit = getObjectHitBy(nextRay);
-        Hit nextHit = nextObjectHit->intersect(nextRay);
+        auto [nextObjectHit, nextHit] = findClosestHit(nextRay);
         if (nextHit == Hit::NO_HIT()) return;
 
-        computeRefractedLightBeam(light, nextHit, nextObjectHit,
-                                  currentColor * nextObjectHit->getColorOnPosition(nextHit.Position));
+        computeRefractedLightBeam(light, nextHit, *nextObjectHit,
+                                  currentColor * (*nextObjectHit)->getColorOnHit(nextHit));
     }
     else {
         if (objectHit->material.refractedLightMaps.find(*light) == objectHit->material.refractedLightMaps.end()) {
             objectHit->material.refractedLightMaps.emplace(std::make_pair(*light, BaseImage<std::optional<std::array<double, 3>>>(refractedShadows->textureSize, refractedShadows->textureSize)));
         }
 
-        std::array<double, 2> uv = objectHit->getTextureCoordinatesFor(hit.Position);
+        std::array<double, 2> uv = objectHit->getTextureCoordinatesFor(hit);
         std::optional<std::array<double, 3>>& pixel = objectHit->material.refractedLightMaps[*light].colorAt(uv[0], uv[1]);
 
         if (! pixel.has_value())
@@ -487,6 +840,7 @@ void Scene::computeRefractedLightBeam(const std::unique_ptr<Light> &light, const
 }
 
 void Scene::smoothenRefractedShadows() {
+    Statistics::PhaseTimer timer{Statistics::Phase::Smoothing};
 
     for (auto & object : objects) {
         for (auto& pair : object->material.refractedLightMaps) {
@@ -498,7 +852,7 @@ void Scene::smoothenRefractedShadows() {
 
                 #pragma omp parallel for
                 for (int x = 0; x < originalImage.width(); ++x) {
-                    for (std::size_t y = 0; y < originalImage.height(); ++y) {
+                    for (int y = 0; y < originalImage.height(); ++y) {
 
                         if (originalImage(x, y).has_value()) {
                             const auto &origin = originalImage(x, y);
@@ -531,8 +885,8 @@ void Scene::smoothenRefractedShadows() {
             }
 
 
-            for (std::size_t x = 0; x < smoothedImage.width(); ++x) {
-                for (std::size_t y = 0; y < smoothedImage.height(); ++y) {
+            for (int x = 0; x < smoothedImage.width(); ++x) {
+                for (int y = 0; y < smoothedImage.height(); ++y) {
                     if (! smoothedImage(x, y).has_value())
                         smoothedImage(x, y).emplace(std::array<double, 3>{0, 0, 0});
                 }
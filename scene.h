@@ -20,6 +20,8 @@
 #include <vector>
 #include <memory>
 #include <array>
+#include <utility>
+#include <functional>
 #include "material.h"
 #include "object.h"
 #include "triple.h"
@@ -27,6 +29,10 @@
 #include "yaml/yaml.h"
 #include "commongeometry.h"
 #include "light.h"
+#include "BoundingVolumeHierarchy.h"
+#include "RayPacket.h"
+#include "TileScheduler.h"
+#include "Heatmap.h"
 
 
 class Object;
@@ -58,6 +64,9 @@ public:
 
     std::array<unsigned int, 2> ViewSize = {400, 400};
 
+    // Angle covered by a pixel, the spread of the ray cones of the primary rays
+    [[nodiscard]] inline double PixelSpread() const { return scale / 1000; }
+
     [[nodiscard]] inline Point ViewDirection(int x, int y, double dx, double dy) const {
 
         Vector directionComponentX = (x - ViewSize[0] / 2.f + dx) * sideDirection * scale;
@@ -89,12 +98,34 @@ struct RefractedShadowsParameters {
     double intensityFactor = 1;
 };
 
+// Rendering settings given on the command line rather than in the scene file
+struct RenderOptions {
+    // Traces the primary rays by packets of neighbouring pixels instead of one by one
+    bool PacketTracing = true;
+    // Side of the square tiles the image is split in between the threads
+    int TileSize = 32;
+    // 0 for one thread per hardware thread
+    unsigned int ThreadCount = 0;
+    // File receiving the time taken by every tile, none if empty
+    std::string TileTimingsFile;
+    // Writes the image band by band while it is rendered, instead of rendering it whole first
+    bool StreamOutput = false;
+    // File receiving the heatmap of the cost of every pixel, none if empty
+    std::string HeatmapFile;
+    CostMetric HeatmapMetric = CostMetric::Time;
+};
+
 
 class Scene
 {
 private:
     std::vector<std::unique_ptr<Object>> objects;
     std::vector<std::unique_ptr<Light>> lights;
+    BoundingVolumeHierarchy objectHierarchy;
+    // Maps the primitives of objectHierarchy to their index in objects
+    std::vector<std::size_t> boundedObjects;
+    // Indices of the objects without bounding box, tested apart from the hierarchy
+    std::vector<std::size_t> unboundedObjects;
     Mode mode;
     int near, far;
     int maxIterations;
@@ -102,19 +133,29 @@ private:
 public:
 
     unsigned int superSamplingFactor;
+    // Traces the superSamplingFactor x superSamplingFactor grid only in the pixels which corners differ
+    // by more than superSamplingThreshold on a channel
+    bool adaptiveSuperSampling = false;
+    double superSamplingThreshold = 0.1;
     Camera camera;
     bool SoftShadows = false;
+    RenderOptions renderOptions;
     GoochIlluminationModel goochIlluminationModel;
 
     unsigned int shadowEdgePrecision, shadowShadePrecision;
 
     std::optional<RefractedShadowsParameters> refractedShadows;
 
-    Color trace(const Ray &ray, int iterations);
-    Color traceZBuf(const Ray &ray);
-    Color traceNormals(const Ray &ray);
-    Color traceTextures(const Ray &ray);
-    Image render();
+    Radiance trace(const Ray &ray, int iterations);
+    Radiance traceZBuf(const Ray &ray);
+    Radiance traceNormals(const Ray &ray);
+    Radiance traceTextures(const Ray &ray);
+    // The unclamped image, clamped only when written to a PNG file
+    RadianceImage render();
+    // Receives the rows [firstRow, firstRow + band.height()) of the image once they are rendered
+    typedef std::function<void(RadianceImage& band, int firstRow)> BandWriter;
+    // Renders the image by bands of rows given in order to writeBand, only one band being held in memory
+    void render(const BandWriter& writeBand);
     void addObject(std::unique_ptr<Object>&& o);
     void addLight(std::unique_ptr<Light>&& l);
     void setMode(Mode mode);
@@ -125,7 +166,20 @@ public:
     unsigned int getNumObjects() const { return objects.size(); }
     unsigned int getNumLights() const { return lights.size(); }
 
+    // Builds the hierarchy used by the queries below, once all the objects are added. Done by render.
+    void buildObjectHierarchy();
+
+    // Object hit first by the ray, nullptr with NO_HIT when nothing is hit
+    typedef std::pair<const std::unique_ptr<Object>*, Hit> ObjectHit;
+
+    ObjectHit findClosestHit(const Ray&, const Object* object_ignored = nullptr) const;
+    // Whether any object is hit before maxDistance, stopping at the first one found
+    bool isOccluded(const Ray&, double maxDistance, const Object* object_ignored = nullptr) const;
+
 private:
+    // Bands of bandHeight rows, the smallest keeping the threads busy for 0
+    void renderBands(int bandHeight, const BandWriter& writeBand);
+
     void computeRefractedShadows();
     bool computeRefractedShadowsAt(
             const std::unique_ptr<Object>& target,
@@ -137,9 +191,14 @@ private:
 
     void smoothenRefractedShadows();
 
+    // Closest hits of the active rays of the packet, objectsHit receiving the object hit by each ray (nullptr without hit)
+    void findClosestHits(RayPacket &packet, RayPacket::Mask activeRays,
+                         RayPacket::Lanes<const std::unique_ptr<Object>*> &objectsHit) const;
 
-    std::unique_ptr<Object>& getObjectHitBy(const Ray&);
-    std::unique_ptr<Object>& getObjectHitBy(const Ray&, const std::unique_ptr<Object> &object_ignored);
+    Radiance shade(const ObjectHit &, int iterations);
+    Radiance shadeZBuf(const ObjectHit &);
+    Radiance shadeNormals(const ObjectHit &);
+    Radiance shadeTextures(const ObjectHit &);
     float getLightFactorFor(const std::unique_ptr<Light> &light, const Hit &hit, const std::unique_ptr<Object> &object_hit);
 
     typedef unsigned char IlluminationType;
@@ -149,12 +208,12 @@ private:
     const IlluminationType specular = 0x04;
     const IlluminationType all = ambient | diffuse | specular;
 
-    Color computeReflection(const Hit &, const Material &, int iterations);
-    Color computeRefraction(const Hit &current_hit, const Material &, int iterations);
-    Color computeIllumination(const Hit &, Scene::IlluminationType, const std::unique_ptr<Object> &object_hit);
+    Radiance computeReflection(const Hit &, const Material &, int iterations);
+    Radiance computeRefraction(const Hit &current_hit, const Material &, int iterations);
+    Radiance computeIllumination(const Hit &, Scene::IlluminationType, const std::unique_ptr<Object> &object_hit);
 
-    Color computePhong(const Hit &current_hit, Scene::IlluminationType illumination, const std::unique_ptr<Object> &object_hit);
-    Color computeGooch(const Hit &, Scene::IlluminationType, const std::unique_ptr<Object> &object_hit);
+    Radiance computePhong(const Hit &current_hit, Scene::IlluminationType illumination, const std::unique_ptr<Object> &object_hit);
+    Radiance computeGooch(const Hit &, Scene::IlluminationType, const std::unique_ptr<Object> &object_hit);
 };
 
 #endif /* end of include guard: SCENE_H_KNBLQLP6 */
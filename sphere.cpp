@@ -16,6 +16,8 @@
 
 #include "sphere.h"
 #include "Plane.h"
+#include "Statistics.h"
+#include <bitset>
 #include <cmath>
 
 #ifndef M_PI
@@ -25,6 +27,63 @@
 /************************** Sphere **********************************/
 
 Hit Sphere::intersect(const Ray &ray) const
+{
+    COUNT_STATISTIC(SphereTests);
+    double distanceToOrigin = getHitDistance(ray);
+    if (distanceToOrigin == Hit::NO_HIT().Distance)
+        return Hit::NO_HIT();
+
+    return getHitAt(ray, distanceToOrigin);
+}
+
+RayPacket::Mask Sphere::intersectPacket(RayPacket &packet, RayPacket::Mask activeRays) const {
+    ADD_STATISTIC(SphereTests, std::bitset<RayPacket::Size>{activeRays}.count());
+    // Same computation as getHitDistance, for every ray of the packet at once
+    RayPacket::Lanes<double> distances;
+    const double radiusSquared = Radius * Radius;
+
+    #pragma omp simd
+    for (std::size_t i = 0; i < RayPacket::Size; ++i) {
+        double x = packet.OriginX[i] - Position.X();
+        double y = packet.OriginY[i] - Position.Y();
+        double z = packet.OriginZ[i] - Position.Z();
+
+        double p = packet.DirectionX[i] * x + packet.DirectionY[i] * y + packet.DirectionZ[i] * z;
+        double q = (x * x + y * y + z * z) - radiusSquared;
+
+        double discriminant = (p * p) - q;
+        double dRoot = std::sqrt(std::max(discriminant, 0.));
+        double distance1 = -p - dRoot, distance2 = -p + dRoot;
+
+        double distance = distance1 > 0 ? distance1 : (distance2 > 0 ? distance2 : Hit::NO_HIT().Distance);
+        distances[i] = discriminant < 0 ? Hit::NO_HIT().Distance : distance;
+    }
+
+    return packet.keepCloserHits(distances, activeRays, [this] (const Ray& ray, double distance) {
+        return getHitAt(ray, distance);
+    });
+}
+
+Hit Sphere::getHitAt(const Ray &ray, double distanceToOrigin) const {
+    // Normal calculation
+    Point intersectionPoint = ray.at(distanceToOrigin);
+    Vector normal = (-Position + intersectionPoint).normalized();
+    Hit output{distanceToOrigin, intersectionPoint, normal, ray};
+
+    if (material.normalMap) {
+        Vector normalUp = Plane{intersectionPoint, normal}.projectOn(Vector{0, 1, 0});
+        output.Normal = applyNormalMap(output, normalUp);
+    }
+
+    return output;
+}
+
+bool Sphere::occludes(const Ray &ray, double maxDistance) const {
+    COUNT_STATISTIC(SphereTests);
+    return getHitDistance(ray) < maxDistance;
+}
+
+double Sphere::getHitDistance(const Ray &ray) const
 {
     // Intersection point calculation
     // source: https://fiftylinesofcode.com/ray-sphere-intersection/
@@ -36,35 +95,26 @@ Hit Sphere::intersect(const Ray &ray) const
     double discriminant = (p * p) - q;
     if (discriminant < 0.0f)
     {
-        return Hit::NO_HIT();
+        return Hit::NO_HIT().Distance;
     }
 
 
     double dRoot = std::sqrt(discriminant);
     double distance1 = -p - dRoot, distance2 = -p + dRoot;
-    double distanceToOrigin;
 
     if (distance1 <= 0) {
         if (distance2 <= 0)
-            return Hit::NO_HIT();
+            return Hit::NO_HIT().Distance;
         else
-            distanceToOrigin = distance2;
+            return distance2;
     }
-    else {
-        // distance 1 is by definition lower than distance2
-        distanceToOrigin = distance1;
-    }
-
-    // Normal calculation
-    Point intersectionPoint = ray.at(distanceToOrigin);
-    Vector normal = (-Position + intersectionPoint).normalized();
-    Vector normalUp = Plane{intersectionPoint, normal}.projectOn(Vector{0, 1, 0});
-    normal = applyNormalMap(intersectionPoint, normal, normalUp);
 
-    return {distanceToOrigin, intersectionPoint, normal, ray};
+    // distance 1 is by definition lower than distance2
+    return distance1;
 }
 
-std::array<double, 2> Sphere::getTextureCoordinatesFor(const Point &p) const {
+std::array<double, 2> Sphere::getTextureCoordinatesFor(const Hit &hit) const {
+    const Point& p = hit.Position;
     constexpr double twoPi = M_PI * 2;
     constexpr double oneOverTwoPi = 1 / twoPi;
 
@@ -85,4 +135,8 @@ std::array<double, 2> Sphere::getTextureCoordinatesFor(const Point &p) const {
 
     double X = theta * oneOverTwoPi;
     return {X, Y};
-}
\ No newline at end of file
+}
+
+std::optional<BoundingBox> Sphere::getBoundingBox() const {
+    return BoundingBox{Position - Radius, Position + Radius};
+}
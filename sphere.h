@@ -27,10 +27,19 @@ public:
     Object(Position), Radius(Radius), Rotation(Rotation.normalized()) { }
 
     [[nodiscard]] Hit intersect(const Ray &ray) const override;
-    [[nodiscard]] std::array<double, 2> getTextureCoordinatesFor(const Point &p) const override;
+    [[nodiscard]] bool occludes(const Ray &ray, double maxDistance) const override;
+    RayPacket::Mask intersectPacket(RayPacket &packet, RayPacket::Mask activeRays) const override;
+    [[nodiscard]] std::array<double, 2> getTextureCoordinatesFor(const Hit &hit) const override;
+    [[nodiscard]] std::optional<BoundingBox> getBoundingBox() const override;
 
     const double Radius;
     const Quaternion Rotation;
+
+private:
+
+    // Distance along the ray to the first hit, infinity without hit
+    [[nodiscard]] double getHitDistance(const Ray &ray) const;
+    [[nodiscard]] Hit getHitAt(const Ray &ray, double distance) const;
 };
 
 #endif /* end of include guard: SPHERE_H_115209AE */
@@ -16,31 +16,17 @@
 #include <cmath>
 
 Color::Color(Color::component red, Color::component green, Color::component blue)
-    : r(red), g(green), b(blue)
+    : values{red, green, blue, 0}
 { }
 
 void Color::set(Color::component red, Color::component green, Color::component blue) {
-    r = red;
-    g = green;
-    b = blue;
-}
-
-Vector::Vector(double x, double y, double z)
-    : x(x), y(y), z(z)
-{ }
-
-double Vector::dot(const Vector &other) const {
-    double sum = 0;
-    for (int i = 0; i < 3; ++i)
-        sum += (*this)[i] * other[i];
-
-    return sum;
+    values[0] = red;
+    values[1] = green;
+    values[2] = blue;
 }
 
 void Vector::normalize() {
-    double n = norm();
-    for (double& direction : *this)
-        direction /= n;
+    *this = *this / norm();
 }
 
 Vector Vector::normalized() const {
@@ -50,11 +36,9 @@ Vector Vector::normalized() const {
 }
 
 Vector Vector::cross(const Vector &other) const {
-    Vector output{};
-
-    output.x = y*other.z - z*other.y;
-    output.y = z*other.x - x*other.z;
-    output.z = x*other.y - y*other.x;
-
-    return output;
+    return Vector{
+        Y()*other.Z() - Z()*other.Y(),
+        Z()*other.X() - X()*other.Z(),
+        X()*other.Y() - Y()*other.X()
+    };
 }
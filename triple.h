@@ -20,6 +20,7 @@
 
 #include <cmath>
 #include <iostream>
+#include "Simd4.h"
 
 template <typename T>
 struct is_triple : std::integral_constant<bool, false> {};
@@ -28,15 +29,20 @@ template <typename T>
 constexpr bool is_triple_v = is_triple<T>::value;
 
 class Color;
+class Radiance;
 class Vector;
 
 template<>
 struct is_triple<Color> : std::integral_constant<bool, true> {};
 template<>
+struct is_triple<Radiance> : std::integral_constant<bool, true> {};
+template<>
 struct is_triple<Vector> : std::integral_constant<bool, true> {};
 template<>
 struct is_triple<const Color> : std::integral_constant<bool, true> {};
 template<>
+struct is_triple<const Radiance> : std::integral_constant<bool, true> {};
+template<>
 struct is_triple<const Vector> : std::integral_constant<bool, true> {};
 
 
@@ -132,7 +138,7 @@ private:
         val = check_val(val);
     }
 
-    static double check_val(double value) {
+    static ValueType check_val(ValueType value) {
         if (value < minimum) {
             value = minimum;
         }
@@ -146,14 +152,50 @@ private:
     ValueType val;
 };
 
+// Reference to a lane of a clamped triple, clamping the values written through it
+template<typename ValueType, int minimum, int maximum>
+class clamped_reference {
+public:
+
+    explicit clamped_reference(ValueType& value) : value(value)
+    { }
+
+    clamped_reference(const clamped_reference&) = default;
+
+    operator ValueType() const { return value; }
+
+    clamped_reference& operator=(ValueType v) { value = clamp(v); return *this; }
+    clamped_reference& operator=(const clamped_reference& other) { return *this = static_cast<ValueType>(other); }
+    clamped_reference& operator+=(ValueType v) { return *this = value + v; }
+    clamped_reference& operator-=(ValueType v) { return *this = value - v; }
+    clamped_reference& operator*=(ValueType v) { return *this = value * v; }
+    clamped_reference& operator/=(ValueType v) { return *this = value / v; }
+
+private:
+
+    static ValueType clamp(ValueType v) {
+        return v < minimum ? minimum : (v > maximum ? maximum : v);
+    }
+
+    ValueType& value;
+};
+
 
+/*
+ * Vector and Color store their three components in the first lanes of a 4-wide, aligned Simd4, the fourth lane
+ * staying 0. The arithmetic operators below work on the whole lanes at once.
+ *
+ * A triple type gives its lanes with lanes(), and builds itself back from lanes with fromLanes (Color clamping them
+ * in [0, 1], as it does every value written in it).
+ *
+ * Color is the type of the stored colors: materials, textures and PNG images. The light carried by the rays is a
+ * Radiance, which is not clamped.
+ */
 class Color {
 public:
 
-    typedef triple_iterator<Color, double> iterator;
-    typedef triple_iterator<const Color, const double> const_iterator;
-
-    typedef clamped_value<double, 0, 1> component;
+    typedef clamped_value<Scalar, 0, 1> component;
+    typedef clamped_reference<Scalar, 0, 1> component_reference;
 
     Color() = default;
     Color(const Color&) = default;
@@ -168,45 +210,110 @@ public:
             : Color(t[0], t[1], t[2])
     { }
 
-    component& Red() { return r; }
-    component& Green() { return g; }
-    component& Blue() { return b; }
-    component Red() const { return r; }
-    component Green() const { return g; }
-    component Blue() const { return b; }
+    // The references are only given by lvalues: a reference into a temporary Color would outlive it
+    component_reference Red() & { return component_reference{values[0]}; }
+    component_reference Green() & { return component_reference{values[1]}; }
+    component_reference Blue() & { return component_reference{values[2]}; }
+    Scalar Red() const& { return values[0]; }
+    Scalar Green() const& { return values[1]; }
+    Scalar Blue() const& { return values[2]; }
+    Scalar Red() && { return values[0]; }
+    Scalar Green() && { return values[1]; }
+    Scalar Blue() && { return values[2]; }
 
     void set(component red, component green, component blue);
 
-    component& operator[] (std::size_t i) {
-        component& (Color::*methods[])() = { &Color::Red, &Color::Green, &Color::Blue };
-        return (this->*methods[i])();
-    }
-    component operator[] (std::size_t i) const {
-        component (Color::*methods[])() const = { &Color::Red, &Color::Green, &Color::Blue };
-        return (this->*methods[i])();
-    }
+    component_reference operator[] (std::size_t i) & { return component_reference{values[i]}; }
+    Scalar operator[] (std::size_t i) const& { return values[i]; }
+    Scalar operator[] (std::size_t i) && { return values[i]; }
 
     bool operator==(const Color& other) const {
         return Red() == other.Red() && Green() == other.Green() && Blue() == other.Blue();
     }
 
-    iterator begin() { return iterator(*this); }
-    iterator end() { return iterator(*this) + 3; }
-    const_iterator cbegin() const { return const_iterator(*this); }
-    const_iterator cend() const { return const_iterator(*this) + 3; }
+    [[nodiscard]] Simd4<Scalar> lanes() const { return Simd4<Scalar>::load(values); }
+    static Color fromLanes(const Simd4<Scalar>& lanes) {
+        Color output;
+        lanes.clamp(0, 1).store(output.values);
+        return output;
+    }
+    // Components already in [0, 1], such as the channel values of the 8 bit textures, stored without clamping them
+    static Color fromUnitComponents(Scalar red, Scalar green, Scalar blue) {
+        Color output;
+        output.values[0] = red;
+        output.values[1] = green;
+        output.values[2] = blue;
+        return output;
+    }
 
 
     ~Color() = default;
 
 private:
-    component r, g, b;
+    alignas(Simd4<Scalar>::Alignment) Scalar values[4] = {};
+};
+
+/*
+ * Light carried by a ray, summed and scaled without being clamped: several lights can add up past 1, and a bright
+ * reflection keeps its intensity when scaled down. It is clamped to a Color only when the image is written.
+ *
+ * A Color converts implicitly to a Radiance, so that the two can be mixed in the arithmetic operators, the result being
+ * a Radiance.
+ */
+class Radiance {
+public:
+
+    Radiance() = default;
+    Radiance(const Radiance&) = default;
+    Radiance(Radiance&&) = default;
+    Radiance& operator=(const Radiance&) = default;
+    Radiance& operator=(Radiance&&) = default;
+
+    Radiance(Scalar red, Scalar green, Scalar blue) : values{red, green, blue, 0}
+    { }
+
+    Radiance(const Color& color)
+    { color.lanes().store(values); }
+
+    template <typename Triple, class = typename std::enable_if<is_triple_v<Triple>, bool>::type>
+    explicit Radiance(const Triple& t)
+            : Radiance(t[0], t[1], t[2])
+    { }
+
+    Scalar& Red() { return values[0]; }
+    Scalar& Green() { return values[1]; }
+    Scalar& Blue() { return values[2]; }
+    Scalar Red() const { return values[0]; }
+    Scalar Green() const { return values[1]; }
+    Scalar Blue() const { return values[2]; }
+
+    void set(Scalar red, Scalar green, Scalar blue) { *this = Radiance{red, green, blue}; }
+
+    Scalar& operator[] (std::size_t i) { return values[i]; }
+    Scalar operator[] (std::size_t i) const { return values[i]; }
+
+    // The displayable color, every component clamped in [0, 1]
+    [[nodiscard]] Color clamped() const { return Color::fromLanes(lanes()); }
+
+    [[nodiscard]] Simd4<Scalar> lanes() const { return Simd4<Scalar>::load(values); }
+    static Radiance fromLanes(const Simd4<Scalar>& lanes) {
+        Radiance output;
+        lanes.store(output.values);
+        return output;
+    }
+
+
+    ~Radiance() = default;
+
+private:
+    alignas(Simd4<Scalar>::Alignment) Scalar values[4] = {};
 };
 
 class Vector {
 public:
 
-    typedef triple_iterator<Vector, double> iterator;
-    typedef triple_iterator<const Vector, const double> const_iterator;
+    typedef triple_iterator<Vector, Scalar> iterator;
+    typedef triple_iterator<const Vector, const Scalar> const_iterator;
 
     Vector() = default;
     Vector(const Vector&) = default;
@@ -214,34 +321,29 @@ public:
     Vector& operator=(const Vector&) = default;
     Vector& operator=(Vector&&) = default;
 
-    Vector(double x, double y, double z);
+    Vector(Scalar x, Scalar y, Scalar z) : values{x, y, z, 0}
+    { }
 
     template <typename Triple, class = typename std::enable_if<is_triple_v<Triple>, bool>::type>
     explicit Vector(const Triple& t)
             : Vector(t[0], t[1], t[2])
     { }
 
-    double& X() { return x; }
-    double& Y() { return y; }
-    double& Z() { return z; }
+    Scalar& X() { return values[0]; }
+    Scalar& Y() { return values[1]; }
+    Scalar& Z() { return values[2]; }
 
-    double X() const { return x; }
-    double Y() const { return y; }
-    double Z() const { return z; }
+    Scalar X() const { return values[0]; }
+    Scalar Y() const { return values[1]; }
+    Scalar Z() const { return values[2]; }
 
-    double& operator[] (std::size_t i) {
-        double& (Vector::*methods[])() = { &Vector::X, &Vector::Y, &Vector::Z };
-        return (this->*methods[i])();
-    }
-    double operator[] (std::size_t i) const {
-        double (Vector::*methods[])() const = { &Vector::X, &Vector::Y, &Vector::Z };
-        return (this->*methods[i])();
-    }
+    Scalar& operator[] (std::size_t i) { return values[i]; }
+    Scalar operator[] (std::size_t i) const { return values[i]; }
 
-    [[nodiscard]] double dot(const Vector& other) const;
+    [[nodiscard]] inline Scalar dot(const Vector& other) const { return (lanes() * other.lanes()).sum3(); }
     [[nodiscard]] Vector cross(const Vector& other) const;
-    [[nodiscard]] inline double norm2() const  { return X()*X() + Y()*Y() + Z()*Z(); }
-    [[nodiscard]] inline double norm() const { return std::sqrt(norm2()); }
+    [[nodiscard]] inline Scalar norm2() const  { return dot(*this); }
+    [[nodiscard]] inline Scalar norm() const { return std::sqrt(norm2()); }
     void normalize();
     [[nodiscard]] Vector normalized() const;
 
@@ -250,16 +352,29 @@ public:
     const_iterator cbegin() const { return const_iterator{*this}; }
     const_iterator cend() const { return const_iterator{*this} + 3; }
 
+    [[nodiscard]] Simd4<Scalar> lanes() const { return Simd4<Scalar>::load(values); }
+    static Vector fromLanes(const Simd4<Scalar>& lanes) {
+        Vector output;
+        lanes.store(output.values);
+        return output;
+    }
+
 
     ~Vector() = default;
 
 private:
-    double x, y, z;
+    alignas(Simd4<Scalar>::Alignment) Scalar values[4] = {};
 };
 
 using Point = Vector;
 
 
+// The number on the three component lanes, fill in the fourth one
+template <typename Number>
+inline Simd4<Scalar> broadcast(Number n, Scalar fill = 0) {
+    auto value = static_cast<Scalar>(n);
+    return Simd4<Scalar>{value, value, value, fill};
+}
 
 template <typename Triple, class = typename std::enable_if<is_triple_v<Triple>, bool>::type>
 bool operator==(const Triple& t1, const Triple& t2) { for (int i = 0; i < 3; ++i) if (t1[i] != t2[i]) { return false; } return true; }
@@ -267,40 +382,48 @@ template <typename Triple, class = typename std::enable_if<is_triple_v<Triple>,
 inline bool operator!=(const Triple& t1, const Triple& t2) { return ! (t1 == t2); }
 
 template <typename Triple, class = typename std::enable_if<is_triple_v<Triple>, bool>::type>
-Triple operator-( const Triple& t1) { Triple output(t1); for (int i = 0; i < 3; ++i) output[i] = -output[i]; return output; }
+inline Triple operator-( const Triple& t1) { return Triple::fromLanes(-t1.lanes()); }
 
 template <typename Triple, class = typename std::enable_if<is_triple_v<Triple>, bool>::type>
-inline Triple& operator+=(Triple& t1, const Triple& t2) { for (int i = 0; i < 3; ++i) t1[i] += t2[i]; return t1; }
+inline Triple operator+(const Triple& t1, const Triple& t2) { return Triple::fromLanes(t1.lanes() + t2.lanes()); }
 template <typename Triple, class = typename std::enable_if<is_triple_v<Triple>, bool>::type>
-inline Triple& operator-=(Triple& t1, const Triple& t2) { return t1 += (-t2); }
-
+inline Triple operator-(const Triple& t1, const Triple& t2) { return Triple::fromLanes(t1.lanes() - t2.lanes()); }
 
 template <typename Triple, class = typename std::enable_if<is_triple_v<Triple>, bool>::type>
-inline Triple operator+(const Triple& t1, const Triple& t2) { Triple output(t1); return output += t2; }
+inline Triple& operator+=(Triple& t1, const Triple& t2) { return t1 = t1 + t2; }
 template <typename Triple, class = typename std::enable_if<is_triple_v<Triple>, bool>::type>
-inline Triple operator-(const Triple& t1, const Triple& t2) { return t1 + (-t2); }
+inline Triple& operator-=(Triple& t1, const Triple& t2) { return t1 = t1 - t2; }
 
-template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, bool = std::is_arithmetic<Number>::value>
-Triple operator+(const Triple& t1, Number n) { Triple output(t1); for (int i = 0; i < 3; ++i) output[i] += n; return output; }
-template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, bool = std::is_arithmetic<Number>::value>
+template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, typename std::enable_if<std::is_arithmetic<Number>::value, bool>::type = true>
+inline Triple operator+(const Triple& t1, Number n) { return Triple::fromLanes(t1.lanes() + broadcast(n)); }
+template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, typename std::enable_if<std::is_arithmetic<Number>::value, bool>::type = true>
 inline Triple operator+(Number n, const Triple& t1) { return t1 + n; }
-template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, bool = std::is_arithmetic<Number>::value>
-inline Triple operator-(const Triple& t1, Number n) { return t1 + (-n); }
-
-template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, bool = std::is_arithmetic<Number>::value>
-Triple& operator*=(Triple& t1, Number n) { for (int i = 0; i < 3; ++i) t1[i] *= n; return t1; }
-template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, bool = std::is_arithmetic<Number>::value>
-Triple operator*(const Triple& t1, Number n) { Triple output(t1); output *= n; return output; }
-template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, bool = std::is_arithmetic<Number>::value>
+template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, typename std::enable_if<std::is_arithmetic<Number>::value, bool>::type = true>
+inline Triple operator-(const Triple& t1, Number n) { return Triple::fromLanes(t1.lanes() - broadcast(n)); }
+
+template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, typename std::enable_if<std::is_arithmetic<Number>::value, bool>::type = true>
+inline Triple operator*(const Triple& t1, Number n) { return Triple::fromLanes(t1.lanes() * broadcast(n)); }
+template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, typename std::enable_if<std::is_arithmetic<Number>::value, bool>::type = true>
+inline Triple& operator*=(Triple& t1, Number n) { return t1 = t1 * n; }
+template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, typename std::enable_if<std::is_arithmetic<Number>::value, bool>::type = true>
 inline Triple operator*(Number n, const Triple& t1) { return t1 * n; }
 template <typename Triple, class = typename std::enable_if<is_triple_v<Triple>, bool>::type>
-Triple& operator*=(Triple& t1, const Triple& t2) { for (int i = 0; i < 3; ++i) t1[i] *= t2[i]; return t1; }
+inline Triple operator*(const Triple& t1, const Triple& t2) { return Triple::fromLanes(t1.lanes() * t2.lanes()); }
 template <typename Triple, class = typename std::enable_if<is_triple_v<Triple>, bool>::type>
-Triple operator*(const Triple& t1, const Triple& t2) { Triple output{t1}; output *= t2; return output; }
-template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, bool = std::is_arithmetic<Number>::value>
-Triple& operator/=(Triple& t1, Number n) { for (int i = 0; i < 3; ++i) t1[i] /= n; return t1; }
-template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, bool = std::is_arithmetic<Number>::value>
-Triple operator/(Triple t1, Number n) { return t1 /= n; }
+inline Triple& operator*=(Triple& t1, const Triple& t2) { return t1 = t1 * t2; }
+// The fourth lane is divided by 1, to stay 0
+template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, typename std::enable_if<std::is_arithmetic<Number>::value, bool>::type = true>
+inline Triple operator/(const Triple& t1, Number n) { return Triple::fromLanes(t1.lanes() / broadcast(n, 1)); }
+template <typename Triple, typename Number, class = typename std::enable_if<is_triple_v<Triple>, bool>::type, typename std::enable_if<std::is_arithmetic<Number>::value, bool>::type = true>
+inline Triple& operator/=(Triple& t1, Number n) { return t1 = t1 / n; }
+
+// Radiance mixed with a Color, converted to a Radiance
+inline Radiance operator+(const Radiance& r1, const Radiance& r2) { return Radiance::fromLanes(r1.lanes() + r2.lanes()); }
+inline Radiance operator-(const Radiance& r1, const Radiance& r2) { return Radiance::fromLanes(r1.lanes() - r2.lanes()); }
+inline Radiance operator*(const Radiance& r1, const Radiance& r2) { return Radiance::fromLanes(r1.lanes() * r2.lanes()); }
+inline Radiance& operator+=(Radiance& r1, const Radiance& r2) { return r1 = r1 + r2; }
+inline Radiance& operator-=(Radiance& r1, const Radiance& r2) { return r1 = r1 - r2; }
+inline Radiance& operator*=(Radiance& r1, const Radiance& r2) { return r1 = r1 * r2; }
 
 
 template <typename Triple, class = typename std::enable_if<is_triple_v<Triple>, bool>::type>
@@ -328,7 +451,7 @@ namespace std
     {
         std::size_t operator()(Vector const& vector) const noexcept
         {
-            return hash_combine<double>(321879388, vector[0], vector[1], vector[2]);
+            return hash_combine<Scalar>(321879388, vector[0], vector[1], vector[2]);
         }
     };
 
@@ -336,12 +459,7 @@ namespace std
     {
         std::size_t operator()(Color const& color) const noexcept
         {
-            return hash_combine<double>(
-                    548971589,
-                    // have to require the inner value of the clamped_value
-                    color[0].operator double(),
-                    color[1].operator double(),
-                    color[2].operator double());
+            return hash_combine<Scalar>(548971589, static_cast<Scalar>(color.Red()), static_cast<Scalar>(color.Green()), static_cast<Scalar>(color.Blue()));
         }
     };
 }
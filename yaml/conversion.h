@@ -7,6 +7,8 @@
 #include "null.h"
 #include <string>
 #include <sstream>
+#include <cctype>
+#include <charconv>
 
 namespace YAML
 {
@@ -33,11 +35,26 @@ namespace YAML
 	YAML_MAKE_STREAM_CONVERT(unsigned short)
 	YAML_MAKE_STREAM_CONVERT(long)
 	YAML_MAKE_STREAM_CONVERT(unsigned long)
-	YAML_MAKE_STREAM_CONVERT(float)
-	YAML_MAKE_STREAM_CONVERT(double)
 	YAML_MAKE_STREAM_CONVERT(long double)
 	
 #undef YAML_MAKE_STREAM_CONVERT
+
+	// floats and doubles, most of the scalars of a document, are read the way the stream would read them (leading
+	// spaces and sign, trailing characters ignored) without constructing one
+#define YAML_MAKE_CHARS_CONVERT(type) \
+	inline bool Convert(const std::string& input, type& output) { \
+		const char *begin = input.data(), *end = begin + input.size(); \
+		while(begin != end && std::isspace(static_cast<unsigned char>(*begin))) \
+			++begin; \
+		if(end - begin >= 2 && begin[0] == '+' && begin[1] != '-') \
+			++begin; \
+		return std::from_chars(begin, end, output).ec == std::errc(); \
+	}
+	
+	YAML_MAKE_CHARS_CONVERT(float)
+	YAML_MAKE_CHARS_CONVERT(double)
+	
+#undef YAML_MAKE_CHARS_CONVERT
 }
 
 #endif // CONVERSION_H_62B23520_7C8E_11DE_8A39_0800200C9A66
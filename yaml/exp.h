@@ -55,6 +55,9 @@ namespace YAML
 		            PlainScalarInFlow = !(BlankOrBreak || RegEx("?,[]{}#&*!|>\'\"%@`", REGEX_OR) || (RegEx("-:", REGEX_OR) + Blank));
 		const RegEx EndScalar = RegEx(':') + (BlankOrBreak || RegEx()),
 		            EndScalarInFlow = (RegEx(':') + (BlankOrBreak || RegEx(",]}", REGEX_OR))) || RegEx(",?[]{}", REGEX_OR);
+		const RegEx ScanScalarEnd = EndScalar || (BlankOrBreak + Comment),
+		            ScanScalarEndInFlow = EndScalarInFlow || (BlankOrBreak + Comment);
+		const RegEx EndOfInput = RegEx();
 
 		const RegEx EscSingleQuote = RegEx("\'\'");
 		const RegEx EscBreak = RegEx('\\') + Break;
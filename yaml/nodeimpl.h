@@ -41,7 +41,8 @@ namespace YAML
 	
 	template <typename T>
 	inline const Node *Node::FindValueForKey(const T& key) const {
-		for(Iterator it=begin();it!=end();++it) {
+		// end() allocates its iterator, which is then built once
+		for(Iterator it=begin(),itEnd=end();it!=itEnd;++it) {
 			T t;
 			if(it.first().Read(t)) {
 				if(key == t)
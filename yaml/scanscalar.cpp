@@ -32,7 +32,7 @@ namespace YAML
 			// Phase #1: scan until line ending
 			
 			std::size_t lastNonWhitespaceChar = scalar.size();
-			while(!params.end.Matches(INPUT) && !Exp::Break.Matches(INPUT)) {
+			while(!params.end->Matches(INPUT) && !Exp::Break.Matches(INPUT)) {
 				if(!INPUT)
 					break;
 
@@ -81,7 +81,7 @@ namespace YAML
 				break;
 
 			// are we done via character match?
-			int n = params.end.Match(INPUT);
+			int n = params.end->Match(INPUT);
 			if(n >= 0) {
 				if(params.eatEnd)
 					INPUT.eat(n);
@@ -15,11 +15,11 @@ namespace YAML
 	enum FOLD { DONT_FOLD, FOLD_BLOCK, FOLD_FLOW };
 
 	struct ScanScalarParams {
-		ScanScalarParams(): eatEnd(false), indent(0), detectIndent(false), eatLeadingWhitespace(0), escape(0), fold(DONT_FOLD),
+		ScanScalarParams(): end(0), eatEnd(false), indent(0), detectIndent(false), eatLeadingWhitespace(0), escape(0), fold(DONT_FOLD),
 			trimTrailingSpaces(0), chomp(CLIP), onDocIndicator(NONE), onTabInIndentation(NONE), leadingSpaces(false) {}
 
 		// input:
-		RegEx end;                      // what condition ends this scalar?
+		const RegEx *end;               // what condition ends this scalar? (not copied for every scalar)
 		bool eatEnd;                    // should we eat that condition when we see it?
 		int indent;                     // what level of indentation should be eaten and ignored?
 		bool detectIndent;              // should we try to autodetect the indent?
@@ -284,7 +284,7 @@ namespace YAML
 
 		// set up the scanning parameters
 		ScanScalarParams params;
-		params.end = (InFlowContext() ? Exp::EndScalarInFlow : Exp::EndScalar) || (Exp::BlankOrBreak + Exp::Comment);
+		params.end = (InFlowContext() ? &Exp::ScanScalarEndInFlow : &Exp::ScanScalarEnd);
 		params.eatEnd = false;
 		params.indent = (InFlowContext() ? 0 : GetTopIndent() + 1);
 		params.fold = FOLD_FLOW;
@@ -322,8 +322,9 @@ namespace YAML
 		bool single = (quote == '\'');
 
 		// setup the scanning parameters
+		RegEx end = (single ? RegEx(quote) && !Exp::EscSingleQuote : RegEx(quote));
 		ScanScalarParams params;
-		params.end = (single ? RegEx(quote) && !Exp::EscSingleQuote : RegEx(quote));
+		params.end = &end;
 		params.eatEnd = true;
 		params.escape = (single ? '\'' : '\\');
 		params.indent = 0;
@@ -359,6 +360,7 @@ namespace YAML
 		std::string scalar;
 
 		ScanScalarParams params;
+		params.end = &Exp::EndOfInput;
 		params.indent = 1;
 		params.detectIndent = true;
 
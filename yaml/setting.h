@@ -19,7 +19,7 @@ namespace YAML
 		Setting(): m_value() {}
 		
 		const T get() const { return m_value; }
-		std::unique_ptr<SettingChangeBase>&& set(const T& value);
+		std::unique_ptr<SettingChangeBase> set(const T& value);
 		void restore(const Setting<T>& oldSetting) {
 			m_value = oldSetting.get();
 		}
@@ -54,10 +54,10 @@ namespace YAML
 	};
 
 	template <typename T>
-	inline std::unique_ptr <SettingChangeBase>&& Setting<T>::set(const T& value) {
+	inline std::unique_ptr <SettingChangeBase> Setting<T>::set(const T& value) {
 		std::unique_ptr <SettingChangeBase> pChange(new SettingChange<T> (this));
 		m_value = value;
-		return std::move(pChange);
+		return pChange;
 	}
 	
 	class SettingChanges: private noncopyable
@@ -79,7 +79,7 @@ namespace YAML
 				(*it)->pop();
 		}
 		
-		void push(std::unique_ptr <SettingChangeBase>& pSettingChange) {
+		void push(std::unique_ptr <SettingChangeBase>&& pSettingChange) {
 			m_settingChanges.push_back(pSettingChange.release());
 		}
 		